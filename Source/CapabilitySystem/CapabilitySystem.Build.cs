@@ -11,7 +11,8 @@ public class CapabilitySystem : ModuleRules
 			{
 				"Core",
 				"EnhancedInput",
-				"DeveloperSettings"
+				"DeveloperSettings",
+				"StructUtils"
 			}
 		);
 
@@ -1,10 +1,79 @@
 ﻿#include "CapabilitySystem/Public/CapabilityAsset.h"
 
 #include "CapabilityMetaHead.h"
+#include "CapabilitySystem/Public/CapabilityInput.h"
+
+void UCapabilitySet::ApplySetConfig(UCapabilityBase* Capability) const {
+    if (!Capability) return;
+    if (bOverrideTickPriority) Capability->SetTickPriority(TickPriority);
+}
+
+namespace {
+    using FDataClassList = TArray<TSubclassOf<UCapabilityDataComponent>>;
+
+    bool Overlaps(const FDataClassList& A, const FDataClassList& B) {
+        for (const auto& ClassA : A) {
+            for (const auto& ClassB : B) {
+                if (ClassA && ClassB && (ClassA->IsChildOf(ClassB) || ClassB->IsChildOf(ClassA))) return true;
+            }
+        }
+        return false;
+    }
+
+    bool Conflicts(const FCapabilityClassConfig& A, const FCapabilityClassConfig& B) {
+        const bool bDeclaredA = !A.ReadsData.IsEmpty() || !A.WritesData.IsEmpty();
+        const bool bDeclaredB = !B.ReadsData.IsEmpty() || !B.WritesData.IsEmpty();
+        if (!bDeclaredA || !bDeclaredB) return true;
+        return Overlaps(A.WritesData, B.WritesData) || Overlaps(A.WritesData, B.ReadsData)
+            || Overlaps(A.ReadsData, B.WritesData);
+    }
+}
+
+const TArray<int32>& UCapabilitySet::GetTickLayers() const {
+    // Class configs are rebuilt when their classes are reinstanced, the layers follow them.
+    const uint32 Generation = UCapabilityBase::GetClassConfigGeneration();
+    if (bTickLayersBuilt && TickLayersGeneration == Generation) return TickLayers;
+    bTickLayersBuilt = true;
+    TickLayersGeneration = Generation;
+
+    TArray<const FCapabilityClassConfig*> Configs;
+    Configs.Reserve(ClassOfCapability.Num());
+    for (const auto& Class : ClassOfCapability) {
+        Configs.Add(Class ? &UCapabilityBase::GetClassConfig(Class) : nullptr);
+    }
+
+    TickLayers.SetNumZeroed(ClassOfCapability.Num());
+    for (int32 i = 0; i < Configs.Num(); ++i) {
+        if (!Configs[i]) continue;
+        for (int32 j = 0; j < i; ++j) {
+            if (Configs[j] && TickLayers[j] >= TickLayers[i] && Conflicts(*Configs[i], *Configs[j])) {
+                TickLayers[i] = TickLayers[j] + 1;
+            }
+        }
+    }
+    return TickLayers;
+}
+
+#if WITH_EDITOR
+void UCapabilitySet::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) {
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+    bTickLayersBuilt = false;
+}
+#endif
+
+void FCapabilityObjectRefSet::CacheInputRefs() {
+    InputRefs.Reset();
+    for (auto Ref : ObjectRefs) {
+        if (UCapabilityInput* InputCap = Cast<UCapabilityInput>(Ref)) InputRefs.Add(InputCap);
+    }
+}
 
 void FCapabilityObjectRefSet::CallBeginPlay() {
-    for (auto Ref : ObjectRefs)
-        if (Ref) Ref->NativeBeginPlay();
+    for (auto Ref : ObjectRefs) {
+        if (!Ref) continue;
+        Ref->SetOwningSetInstance(InstanceID);
+        Ref->NativeBeginPlay();
+    }
 }
 
 void FCapabilityObjectRefSet::CallPreEndPlay() {
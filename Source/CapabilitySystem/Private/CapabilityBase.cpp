@@ -1,10 +1,234 @@
 ﻿#include "CapabilitySystem/Public/CapabilityBase.h"
+#include "CapabilitySystem/Public/CapabilityBatchTick.h"
+#include "CapabilitySystem/Public/CapabilityBlockChannel.h"
 #include "CapabilitySystem/Public/CapabilityComponent.h"
 #include "CapabilitySystem/Public/CapabilityMetaHead.h"
+#include "CapabilitySystem/Public/CapabilitySystemSetting.h"
 #include "Net/UnrealNetwork.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/UObjectGlobals.h"
+
+#if !UE_BUILD_SHIPPING
+static TAutoConsoleVariable<bool> CVarValidateDataAccess(
+    TEXT("CapabilitySystem.ValidateDataAccess"), false,
+    TEXT("Warn once per capability / data component class pair when a capability with declared ReadsData / WritesData ")
+    TEXT("looks up a data component it did not declare while ticking."));
+
+static thread_local const UCapabilityBase* GTickingCapability = nullptr;
+
+FCapabilityDataAccessScope::FCapabilityDataAccessScope(const UCapabilityBase* Capability) : Previous(GTickingCapability) {
+    GTickingCapability = Capability;
+}
+
+FCapabilityDataAccessScope::~FCapabilityDataAccessScope() { GTickingCapability = Previous; }
+
+const UCapabilityBase* FCapabilityDataAccessScope::GetCurrent() { return GTickingCapability; }
+#endif
 
 UCapabilityBase::UCapabilityBase(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer) {}
 
+SIZE_T FCapabilityClassConfig::GetAllocatedSize() const {
+    return sizeof(FCapabilityClassConfig) + Tags.GetAllocatedSize() + LODTickIntervals.GetAllocatedSize()
+        + ReadsData.GetAllocatedSize() + WritesData.GetAllocatedSize();
+}
+
+SIZE_T FCapabilityConfigOverride::GetAllocatedSize() const {
+    return sizeof(FCapabilityConfigOverride) + (Tags ? Tags->GetAllocatedSize() : 0)
+        + (LODTickIntervals ? LODTickIntervals->GetAllocatedSize() : 0)
+        + (ReadsData ? ReadsData->GetAllocatedSize() : 0) + (WritesData ? WritesData->GetAllocatedSize() : 0);
+}
+
+namespace {
+    struct FCapabilityClassConfigCache {
+        TMap<TObjectKey<UClass>, TUniquePtr<FCapabilityClassConfig>> Configs;
+
+        // Dropped by Invalidate while capabilities still resolve to them, freed by Release once unreferenced.
+        TArray<TUniquePtr<FCapabilityClassConfig>> Retired;
+
+        uint32 Generation = 0;
+
+        FCapabilityClassConfigCache() {
+            FCoreUObjectDelegates::OnObjectsReinstanced.AddRaw(this, &FCapabilityClassConfigCache::OnObjectsReinstanced);
+        }
+
+        // Blueprint recompile and hot reload regenerate class defaults, rebuild every config on next use.
+        void OnObjectsReinstanced(const TMap<UObject*, UObject*>& Replaced) {
+            for (const auto& Pair : Replaced) {
+                const UObject* Object = Pair.Value ? Pair.Value : Pair.Key;
+                const UClass* Class = Cast<UClass>(Object);
+                if (Class ? Class->IsChildOf<UCapabilityBase>() : Object && Object->IsA<UCapabilityBase>()) {
+                    Invalidate();
+                    return;
+                }
+            }
+        }
+
+        void Invalidate() {
+            if (Configs.IsEmpty()) return;
+            for (auto& Pair : Configs) {
+                DEC_DWORD_STAT(STAT_CapabilityClassConfigCount);
+                if (Pair.Value->RefCount > 0) {
+                    Pair.Value->bRetired = true;
+                    Retired.Add(MoveTemp(Pair.Value));
+                } else {
+                    DEC_MEMORY_STAT_BY(STAT_CapabilityConfigMemory, Pair.Value->GetAllocatedSize());
+                }
+            }
+            Configs.Reset();
+            ++Generation;
+        }
+
+        void Release(const FCapabilityClassConfig* Config) {
+            if (--Config->RefCount > 0 || !Config->bRetired) return;
+            const int32 Index = Retired.IndexOfByPredicate([Config](const TUniquePtr<FCapabilityClassConfig>& Entry) {
+                return Entry.Get() == Config;
+            });
+            if (Index == INDEX_NONE) return;
+            DEC_MEMORY_STAT_BY(STAT_CapabilityConfigMemory, Config->GetAllocatedSize());
+            Retired.RemoveAtSwap(Index);
+        }
+    };
+
+    FCapabilityClassConfigCache& GetClassConfigCache() {
+        static FCapabilityClassConfigCache Cache;
+        return Cache;
+    }
+}
+
+const FCapabilityClassConfig& UCapabilityBase::GetClassConfig(const UClass* Class) {
+    check(IsInGameThread());
+    auto& Cache = GetClassConfigCache();
+
+    if (const auto Found = Cache.Configs.Find(Class)) return **Found;
+
+    const auto CDO = CastChecked<UCapabilityBase>(Class->GetDefaultObject());
+    auto& NewConfig = Cache.Configs.Add(Class, MakeUnique<FCapabilityClassConfig>(CDO->ReadConfigProperties()));
+    INC_DWORD_STAT(STAT_CapabilityClassConfigCount);
+    INC_MEMORY_STAT_BY(STAT_CapabilityConfigMemory, NewConfig->GetAllocatedSize());
+    return *NewConfig;
+}
+
+uint32 UCapabilityBase::GetClassConfigGeneration() {
+    return GetClassConfigCache().Generation;
+}
+
+FCapabilityClassConfig UCapabilityBase::ReadConfigProperties() const {
+    FCapabilityClassConfig Result;
+    Result.Tags = Tags;
+    Result.LODTickIntervals = LODTickIntervals;
+    Result.ReadsData = ReadsData;
+    Result.WritesData = WritesData;
+    return Result;
+}
+
+void UCapabilityBase::ResolveClassConfig() {
+    if (Config) return;
+
+    Config = &GetClassConfig(GetClass());
+    ++Config->RefCount;
+
+    // Arrays changed after construction keep an override, the instance copies are freed either way.
+    if (Tags != Config->Tags) GetMutableOverride().Tags = MoveTemp(Tags);
+    if (LODTickIntervals != Config->LODTickIntervals) GetMutableOverride().LODTickIntervals = MoveTemp(LODTickIntervals);
+    if (ReadsData != Config->ReadsData) GetMutableOverride().ReadsData = MoveTemp(ReadsData);
+    if (WritesData != Config->WritesData) GetMutableOverride().WritesData = MoveTemp(WritesData);
+    Tags.Empty();
+    LODTickIntervals.Empty();
+    ReadsData.Empty();
+    WritesData.Empty();
+    if (ConfigOverride) INC_MEMORY_STAT_BY(STAT_CapabilityConfigMemory, ConfigOverride->GetAllocatedSize());
+}
+
+FCapabilityConfigOverride& UCapabilityBase::GetMutableOverride() {
+    if (!ConfigOverride) {
+        ConfigOverride = MakeUnique<FCapabilityConfigOverride>();
+        INC_DWORD_STAT(STAT_CapabilityConfigOverrideCount);
+    }
+    return *ConfigOverride;
+}
+
+void UCapabilityBase::ReleaseOverrideIfEmpty() {
+    if (!ConfigOverride || !ConfigOverride->IsEmpty()) return;
+    DEC_DWORD_STAT(STAT_CapabilityConfigOverrideCount);
+    DEC_MEMORY_STAT_BY(STAT_CapabilityConfigMemory, ConfigOverride->GetAllocatedSize());
+    ConfigOverride.Reset();
+}
+
+void UCapabilityBase::BeginDestroy() {
+    if (ConfigOverride) {
+        DEC_DWORD_STAT(STAT_CapabilityConfigOverrideCount);
+        DEC_MEMORY_STAT_BY(STAT_CapabilityConfigMemory, ConfigOverride->GetAllocatedSize());
+        ConfigOverride.Reset();
+    }
+    if (Config) {
+        GetClassConfigCache().Release(Config);
+        Config = nullptr;
+    }
+    Super::BeginDestroy();
+}
+
+void UCapabilityBase::SetTags(const TArray<FName>& InTags) {
+    if (auto Manager = GetCapabilityComponent()) Manager->bLookupIndexDirty = true;
+    if (!Config) {
+        Tags = InTags;
+        return;
+    }
+
+    // Only the tags go into the override, and they leave it again once they match the class.
+    FCapabilityConfigOverride& Override = GetMutableOverride();
+    DEC_MEMORY_STAT_BY(STAT_CapabilityConfigMemory, Override.GetAllocatedSize());
+    if (InTags == Config->Tags) {
+        Override.Tags.Reset();
+    } else {
+        Override.Tags = InTags;
+    }
+    INC_MEMORY_STAT_BY(STAT_CapabilityConfigMemory, Override.GetAllocatedSize());
+    ReleaseOverrideIfEmpty();
+}
+
+void UCapabilityBase::SetDataAccess(const TArray<TSubclassOf<UCapabilityDataComponent>>& InReads,
+                                    const TArray<TSubclassOf<UCapabilityDataComponent>>& InWrites) {
+    if (Config) {
+        UE_LOG(CapabilitySystemLog, Warning, TEXT("UCapabilityBase::SetDataAccess %s ignored after begin play"), *GetName());
+        return;
+    }
+    ReadsData = InReads;
+    WritesData = InWrites;
+}
+
+void UCapabilityBase::SetLODTickIntervals(const TArray<float>& InIntervals) {
+    if (Config) {
+        UE_LOG(CapabilitySystemLog, Warning, TEXT("UCapabilityBase::SetLODTickIntervals %s ignored after begin play"), *GetName());
+        return;
+    }
+    LODTickIntervals = InIntervals;
+}
+
+void UCapabilityBase::SetExecuteSide(ECapabilityExecuteSide Mode) {
+    executeSide = Mode;
+}
+
+void UCapabilityBase::SetCanEverTick(bool bCanTick) {
+    bCanEverTick = bCanTick;
+}
+
+void UCapabilityBase::SetTickInterval(float InInterval) {
+    tickInterval = InInterval;
+}
+
+void UCapabilityBase::SetUseFixedTimestep(bool bEnable) {
+    if (bFixedTimestep == bEnable) return;
+    bFixedTimestep = bEnable;
+    if (auto Manager = GetCapabilityComponent()) {
+        Manager->NotifyShouldUpdateTickStatusNextFrame();
+    }
+}
+
+void UCapabilityBase::SetTickPriority(ECapabilityTickPriority InPriority) {
+    tickPriority = InPriority;
+}
+
 void UCapabilityBase::GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const {
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
     DOREPLIFETIME_CONDITION_NOTIFY(ThisClass, TargetCapabilityComponent, COND_InitialOnly, REPNOTIFY_OnChanged);
@@ -29,7 +253,7 @@ FString UCapabilityBase::GetString() {
 void UCapabilityBase::Activate() {
     if (bIsCapabilityActive) return;
     bIsCapabilityActive = true;
-    if (bCanEverTick) bIsTickEnabled = true;
+    if (GetCanEverTick()) bIsTickEnabled = true;
     OnActivated();
 }
 
@@ -37,9 +261,233 @@ void UCapabilityBase::Deactivate() {
     if (!bIsCapabilityActive) return;
     bIsCapabilityActive = false;
     bIsTickEnabled = false;
+    CancelAllTasks();
     OnDeactivated();
 }
 
+void UCapabilityBase::WakeUp() {
+    if (!bHasBegunPlay || bHasPreEndedPlay) return;
+    if (!ShouldRunOnThisSide()) return;
+
+    if (const auto Comp = GetCapabilityComponent(); Comp && Comp->IsTagsBlocked(GetTags())) {
+        Deactivate();
+        return;
+    }
+
+    UpdateCapabilityState();
+}
+
+UCapabilityTimerSubsystem* UCapabilityBase::GetTimerSubsystem() const {
+    const AActor* Owner = GetOwner();
+    const UWorld* World = Owner ? Owner->GetWorld() : nullptr;
+    return World ? World->GetSubsystem<UCapabilityTimerSubsystem>() : nullptr;
+}
+
+FCapabilityTimerHandle UCapabilityBase::StartTimer(FCapabilityTimer&& Timer, float Delay, float Interval) {
+    if (!bHasBegunPlay || bHasPreEndedPlay) return FCapabilityTimerHandle();
+    const auto Timers = GetTimerSubsystem();
+    if (!Timers) return FCapabilityTimerHandle();
+
+    const FCapabilityTimerHandle Handle = Timers->SetTimer(this, MoveTemp(Timer), Delay, Interval);
+    ActiveTimers.Add(Handle);
+    return Handle;
+}
+
+FCapabilityTimerHandle UCapabilityBase::SetCapabilityTimer(FCapabilityTimerDelegate Delegate, float Delay, float Interval) {
+    FCapabilityTimer Timer;
+    Timer.Delegate = MoveTemp(Delegate);
+    return StartTimer(MoveTemp(Timer), Delay, Interval);
+}
+
+FCapabilityTimerHandle UCapabilityBase::SetCapabilityTimer(TFunction<void()>&& Callback, float Delay, float Interval) {
+    FCapabilityTimer Timer;
+    Timer.Callback = MoveTemp(Callback);
+    return StartTimer(MoveTemp(Timer), Delay, Interval);
+}
+
+FCapabilityTimerHandle UCapabilityBase::SetWakeUpTimer(float Delay, float Interval) {
+    FCapabilityTimer Timer;
+    Timer.bWakeUp = true;
+    return StartTimer(MoveTemp(Timer), Delay, Interval);
+}
+
+void UCapabilityBase::ClearCapabilityTimer(FCapabilityTimerHandle& Handle) {
+    if (!Handle.IsValid()) return;
+    ActiveTimers.RemoveSwap(Handle);
+    if (const auto Timers = GetTimerSubsystem()) Timers->ClearTimer(Handle);
+    Handle.Invalidate();
+}
+
+void UCapabilityBase::ClearAllCapabilityTimers() {
+    if (ActiveTimers.IsEmpty()) return;
+    if (const auto Timers = GetTimerSubsystem()) {
+        for (auto& Handle : ActiveTimers) Timers->ClearTimer(Handle);
+    }
+    ActiveTimers.Reset();
+}
+
+namespace {
+    FCapabilityTask MakeTask(TFunction<void()>&& Then) {
+        FCapabilityTask Task;
+        Task.Then = MoveTemp(Then);
+        return Task;
+    }
+
+    FCapabilityTask MakeTask(FCapabilityTaskDelegate&& Delegate) {
+        FCapabilityTask Task;
+        Task.Delegate = MoveTemp(Delegate);
+        return Task;
+    }
+
+    void RunTask(FCapabilityTask& Task) {
+        if (Task.Then) Task.Then();
+        else Task.Delegate.ExecuteIfBound();
+    }
+}
+
+FCapabilityTaskHandle UCapabilityBase::StartTask(FCapabilityTask&& Task,
+                                                 TFunctionRef<TFunction<void()>(uint64)> Subscribe) {
+    if (!bHasBegunPlay || bHasPreEndedPlay) return FCapabilityTaskHandle();
+
+    const uint64 Id = NextTaskId++;
+    Task.Id = Id;
+    Task.Unsubscribe = Subscribe(Id);
+    PendingTasks.Add(MoveTemp(Task));
+    INC_DWORD_STAT(STAT_PendingCapabilityTasks);
+    return FCapabilityTaskHandle(Id);
+}
+
+void UCapabilityBase::ResumeTask(uint64 Id) {
+    const int32 Index = PendingTasks.IndexOfByPredicate([Id](const FCapabilityTask& Task) { return Task.Id == Id; });
+    if (Index == INDEX_NONE) return;
+
+    // Off the list before continuing, Then may start the next wait.
+    FCapabilityTask Task = MoveTemp(PendingTasks[Index]);
+    PendingTasks.RemoveAtSwap(Index);
+    DEC_DWORD_STAT(STAT_PendingCapabilityTasks);
+    if (Task.Unsubscribe) Task.Unsubscribe();
+    RunTask(Task);
+}
+
+void UCapabilityBase::CancelTask(FCapabilityTaskHandle& Handle) {
+    const uint64 Id = Handle.Id;
+    Handle.Invalidate();
+    const int32 Index = PendingTasks.IndexOfByPredicate([Id](const FCapabilityTask& Task) { return Task.Id == Id; });
+    if (Index == INDEX_NONE) return;
+
+    FCapabilityTask Task = MoveTemp(PendingTasks[Index]);
+    PendingTasks.RemoveAtSwap(Index);
+    DEC_DWORD_STAT(STAT_PendingCapabilityTasks);
+    if (Task.Unsubscribe) Task.Unsubscribe();
+}
+
+void UCapabilityBase::CancelAllTasks() {
+    if (PendingTasks.IsEmpty()) return;
+    auto Tasks = MoveTemp(PendingTasks);
+    DEC_DWORD_STAT_BY(STAT_PendingCapabilityTasks, Tasks.Num());
+    for (auto& Task : Tasks) {
+        if (Task.Unsubscribe) Task.Unsubscribe();
+    }
+}
+
+bool UCapabilityBase::IsTaskPending(const FCapabilityTaskHandle& Handle) const {
+    return Handle.IsValid() && PendingTasks.ContainsByPredicate([Id = Handle.Id](const FCapabilityTask& Task) {
+        return Task.Id == Id;
+    });
+}
+
+FCapabilityTaskHandle UCapabilityBase::StartDelayTask(float Seconds, FCapabilityTask&& Task) {
+    // Without a timer the delay would never resume, drop the task instead of leaving it pending.
+    if (!GetTimerSubsystem()) {
+        UE_LOGFMT(CapabilitySystemLog, Warning, "UCapabilityBase::WaitDelay - No capability timer subsystem {0} - {1}",
+                  GetOwner() ? *GetOwner()->GetName() : TEXT("Unknown"), *GetName());
+        return FCapabilityTaskHandle();
+    }
+    return StartTask(MoveTemp(Task), [this, Seconds](uint64 Id) -> TFunction<void()> {
+        FCapabilityTimerHandle Timer = SetCapabilityTimer([this, Id] { ResumeTask(Id); }, Seconds);
+        return [this, Timer]() mutable { ClearCapabilityTimer(Timer); };
+    });
+}
+
+FCapabilityTaskHandle UCapabilityBase::StartTagUnblockedTask(FName Tag, FCapabilityTask&& Task) {
+    if (!bHasBegunPlay || bHasPreEndedPlay) return FCapabilityTaskHandle();
+    UCapabilityComponent* Comp = GetCapabilityComponent();
+    if (!Comp || !Comp->IsTagsBlocked({Tag})) {
+        RunTask(Task);
+        return FCapabilityTaskHandle();
+    }
+
+    return StartTask(MoveTemp(Task), [this, Comp, Tag](uint64 Id) -> TFunction<void()> {
+        // Block info and channel changes only say something changed, check the tag again.
+        auto Recheck = [this, Id, Tag] {
+            const auto Current = GetCapabilityComponent();
+            if (Current && !Current->IsTagsBlocked({Tag})) ResumeTask(Id);
+        };
+        const FDelegateHandle BlockHandle = Comp->OnBlockInfoChanged.AddWeakLambda(this, Recheck);
+
+        const UWorld* World = Comp->GetWorld();
+        const auto Channels = World ? World->GetSubsystem<UCapabilityBlockChannelSubsystem>() : nullptr;
+        const FDelegateHandle ChannelHandle = Channels ? Channels->OnChannelsChanged.AddWeakLambda(this, Recheck)
+                                                       : FDelegateHandle();
+
+        return [WeakComp = TWeakObjectPtr<UCapabilityComponent>(Comp),
+                WeakChannels = TWeakObjectPtr<UCapabilityBlockChannelSubsystem>(Channels), BlockHandle, ChannelHandle] {
+            if (const auto Target = WeakComp.Get()) Target->OnBlockInfoChanged.Remove(BlockHandle);
+            if (const auto Subsystem = WeakChannels.Get()) Subsystem->OnChannelsChanged.Remove(ChannelHandle);
+        };
+    });
+}
+
+FCapabilityTaskHandle UCapabilityBase::StartDataNotifyTask(UCapabilityDataComponent* Data, FName Key,
+                                                           FCapabilityTask&& Task) {
+    if (!IsValid(Data)) return FCapabilityTaskHandle();
+
+    return StartTask(MoveTemp(Task), [this, Data, Key](uint64 Id) -> TFunction<void()> {
+        const FDelegateHandle Handle = Data->OnDataNotify.AddWeakLambda(this, [this, Id, Key](FName Notified) {
+            if (Key.IsNone() || Key == Notified) ResumeTask(Id);
+        });
+        return [WeakData = TWeakObjectPtr<UCapabilityDataComponent>(Data), Handle] {
+            if (const auto Target = WeakData.Get()) Target->OnDataNotify.Remove(Handle);
+        };
+    });
+}
+
+FCapabilityTaskHandle UCapabilityBase::WaitDelay(float Seconds, FCapabilityTaskDelegate Then) {
+    return StartDelayTask(Seconds, MakeTask(MoveTemp(Then)));
+}
+
+FCapabilityTaskHandle UCapabilityBase::WaitDelay(float Seconds, TFunction<void()>&& Then) {
+    return StartDelayTask(Seconds, MakeTask(MoveTemp(Then)));
+}
+
+FCapabilityTaskHandle UCapabilityBase::WaitTagUnblocked(FName Tag, FCapabilityTaskDelegate Then) {
+    return StartTagUnblockedTask(Tag, MakeTask(MoveTemp(Then)));
+}
+
+FCapabilityTaskHandle UCapabilityBase::WaitTagUnblocked(FName Tag, TFunction<void()>&& Then) {
+    return StartTagUnblockedTask(Tag, MakeTask(MoveTemp(Then)));
+}
+
+FCapabilityTaskHandle UCapabilityBase::WaitDataNotify(UCapabilityDataComponent* Data, FName Key,
+                                                      FCapabilityTaskDelegate Then) {
+    return StartDataNotifyTask(Data, Key, MakeTask(MoveTemp(Then)));
+}
+
+FCapabilityTaskHandle UCapabilityBase::WaitDataNotify(UCapabilityDataComponent* Data, FName Key,
+                                                      TFunction<void()>&& Then) {
+    return StartDataNotifyTask(Data, Key, MakeTask(MoveTemp(Then)));
+}
+
+bool UCapabilityBase::IsCapabilityTimerActive(const FCapabilityTimerHandle& Handle) const {
+    const auto Timers = Handle.IsValid() ? GetTimerSubsystem() : nullptr;
+    return Timers && Timers->IsTimerActive(Handle);
+}
+
+float UCapabilityBase::GetCapabilityTimerRemaining(const FCapabilityTimerHandle& Handle) const {
+    const auto Timers = Handle.IsValid() ? GetTimerSubsystem() : nullptr;
+    return Timers ? Timers->GetTimerRemainingTime(Handle) : 0.0f;
+}
+
 bool UCapabilityBase::IsSideLocalControlled() const {
     AActor* Owner = GetOwner();
     if (!Owner) {
@@ -97,9 +545,9 @@ bool UCapabilityBase::IsSideAllClients() const {
     return NetMode != NM_DedicatedServer;
 }
 
-void UCapabilityBase::BlockCapability(const FName& Tag, UObject* From) {
+void UCapabilityBase::BlockCapability(const FName& Tag, UObject* From, float Duration) {
     if (auto Comp = GetCapabilityComponent())
-        Comp->BlockCapability(Tag, From);
+        Comp->BlockCapability(Tag, From, Duration);
 }
 
 void UCapabilityBase::UnBlockCapability(const FName& Tag, UObject* From) {
@@ -132,6 +580,7 @@ void UCapabilityBase::NativeBeginPlay() {
     const auto Comp = GetCapabilityComponent();
     if (!Comp || !Comp->HasBegunPlay()) return;
 
+    ResolveClassConfig();
     bHasBegunPlay = true;
     BeginPlay();
 }
@@ -140,6 +589,7 @@ void UCapabilityBase::NativePreEndPlay() {
     if (bHasPreEndedPlay) return;
     
     bHasPreEndedPlay = true;
+    CancelAllTasks();
     if (bIsCapabilityActive) {
         bIsCapabilityActive = false;
         OnDeactivated();
@@ -155,27 +605,189 @@ void UCapabilityBase::NativeEndPlay() {
     }
     EndLife();
     EndPlay();
+    CancelAllTasks();
+    ClearAllCapabilityTimers();
+    if (BatchBucket != INDEX_NONE) {
+        const UWorld* World = GetOwner() ? GetOwner()->GetWorld() : nullptr;
+        if (const auto BatchTick = World ? World->GetSubsystem<UCapabilityBatchTickSubsystem>() : nullptr) {
+            BatchTick->Unregister(this);
+        }
+    }
+    if (bHasEventSubscriptions) {
+        bHasEventSubscriptions = false;
+        if (const auto Comp = GetCapabilityComponent()) Comp->UnsubscribeEvents(this);
+    }
     DEC_DWORD_STAT(STAT_CapabilityCount);
 }
 
 void UCapabilityBase::NativeTick(float DeltaTime) {
-    if (tickInterval <= 0.0f) {
+    if (fixedTimestep > 0.0f) {
+        NativeFixedTick(DeltaTime);
+        return;
+    }
+
+    const float Interval = GetEffectiveTickInterval();
+    if (Interval <= 0.0f) {
         UpdateCapabilityState();
-        if (bIsCapabilityActive) Tick(DeltaTime);
+        if (bIsCapabilityActive) RunTick(DeltaTime);
         return;
     }
 
     tickTimeSum += DeltaTime;
-    if (tickTimeSum >= tickInterval) {
-        tickTimeSum -= tickInterval;
+    if (tickTimeSum >= Interval) {
+        // Hand over the whole elapsed time, a throttled capability must not run slower than real time.
+        const float Elapsed = tickTimeSum;
+        tickTimeSum = 0.0f;
+        UpdateCapabilityState();
+        if (bIsCapabilityActive) RunTick(Elapsed);
+    }
+}
+
+void UCapabilityBase::RunTick(float DeltaTime) {
+#if !UE_BUILD_SHIPPING
+    FCapabilityDataAccessScope AccessScope(this);
+#endif
+    if (GetParallelTick()) TickParallel(DeltaTime);
+    else Tick(DeltaTime);
+}
+
+int32 UCapabilityBase::PrepareParallelTick(float DeltaTime, float& OutDelta) {
+    if (fixedTimestep > 0.0f) {
+        OutDelta = GetFixedStepDelta();
+        tickTimeSum += DeltaTime;
+        const int32 Steps = FMath::Min(FMath::FloorToInt(tickTimeSum / OutDelta), maxFixedSubsteps);
+        tickTimeSum -= Steps * OutDelta;
+        INC_DWORD_STAT_BY(STAT_CapabilityFixedSteps, Steps);
+        DropExcessFixedSteps(OutDelta);
+        // Activation is evaluated once for all the steps of the frame.
+        if (Steps > 0) UpdateCapabilityState();
+        return Steps;
+    }
+
+    OutDelta = DeltaTime;
+    const float Interval = GetEffectiveTickInterval();
+    if (Interval > 0.0f) {
+        tickTimeSum += DeltaTime;
+        if (tickTimeSum < Interval) return 0;
+        OutDelta = tickTimeSum;
+        tickTimeSum = 0.0f;
+    }
+    UpdateCapabilityState();
+    return 1;
+}
+
+void UCapabilityBase::ValidateDataAccess(const UClass* DataClass, bool bWrite) const {
+#if !UE_BUILD_SHIPPING
+    if (!DataClass || !CVarValidateDataAccess.GetValueOnAnyThread() || !HasDeclaredDataAccess()) return;
+
+    auto IsDeclared = [DataClass](const TArray<TSubclassOf<UCapabilityDataComponent>>& Declared) {
+        for (const auto& Class : Declared) {
+            if (Class && (DataClass->IsChildOf(Class) || Class->IsChildOf(DataClass))) return true;
+        }
+        return false;
+    };
+    if (IsDeclared(GetWritesData())) return;
+    const bool bDeclaredRead = IsDeclared(GetReadsData());
+    if (bDeclaredRead && !bWrite) return;
+
+    static FCriticalSection ReportedLock;
+    static TSet<TTuple<const UClass*, const UClass*, bool>> Reported;
+    {
+        FScopeLock Lock(&ReportedLock);
+        bool bAlreadyReported = false;
+        Reported.Add(MakeTuple(GetClass(), DataClass, bWrite), &bAlreadyReported);
+        if (bAlreadyReported) return;
+    }
+    if (bDeclaredRead) {
+        UE_LOG(CapabilitySystemLog, Warning,
+               TEXT("UCapabilityBase::ValidateDataAccess %s writes %s, which it only declares in ReadsData"),
+               *GetClass()->GetName(), *DataClass->GetName());
+    } else {
+        UE_LOG(CapabilitySystemLog, Warning,
+               TEXT("UCapabilityBase::ValidateDataAccess %s %s %s without declaring it in %s"),
+               *GetClass()->GetName(), bWrite ? TEXT("writes") : TEXT("reads"), *DataClass->GetName(),
+               bWrite ? TEXT("WritesData") : TEXT("ReadsData / WritesData"));
+    }
+#endif
+}
+
+void UCapabilityBase::NativeFixedTick(float DeltaTime) {
+    const float Step = GetFixedStepDelta();
+    tickTimeSum += DeltaTime;
+
+    int32 Steps = 0;
+    while (tickTimeSum >= Step && Steps < maxFixedSubsteps) {
+        tickTimeSum -= Step;
+        ++Steps;
         UpdateCapabilityState();
-        if (bIsCapabilityActive) Tick(DeltaTime);
+        if (bIsCapabilityActive) RunTick(Step);
+        if (bHasEndedPlay) break;
+    }
+    INC_DWORD_STAT_BY(STAT_CapabilityFixedSteps, Steps);
+    DropExcessFixedSteps(Step);
+}
+
+void UCapabilityBase::DropExcessFixedSteps(float Step) {
+    if (tickTimeSum < Step) return;
+    const int32 Dropped = FMath::FloorToInt(tickTimeSum / Step);
+    tickTimeSum -= Dropped * Step;
+    INC_DWORD_STAT_BY(STAT_CapabilityDroppedFixedSteps, Dropped);
+}
+
+void UCapabilityBase::NativeSerializeRollbackState(FArchive& Ar) {
+    Ar << bIsCapabilityActive;
+    Ar << bIsTickEnabled;
+    Ar << tickTimeSum;
+    Ar << deferredTime;
+    SerializeRollbackState(Ar);
+}
+
+void UCapabilityBase::ApplyFixedTimestep(float Step, int32 MaxSubsteps) {
+    Step = FMath::Max(Step, 0.0f);
+    if (fixedTimestep != Step) {
+        fixedTimestep = Step;
+        tickTimeSum = 0.0f;
+    }
+    maxFixedSubsteps = FMath::Max(MaxSubsteps, 1);
+}
+
+float UCapabilityBase::GetFixedStepDelta() const {
+    if (fixedTimestep <= 0.0f) return 0.0f;
+    const float Interval = GetTickInterval();
+    return Interval > 0.0f ? Interval : fixedTimestep;
+}
+
+float UCapabilityBase::GetEffectiveTickInterval() const {
+    if (lodOverrideTickInterval >= 0.0f) return lodOverrideTickInterval;
+    return FMath::Max(GetTickInterval() * lodTickIntervalScale, lodMinTickInterval);
+}
+
+void UCapabilityBase::ApplyLODTier(int32 Tier, const FCapabilityLODTier* TierInfo) {
+    lodTickIntervalScale = 1.0f;
+    lodMinTickInterval = 0.0f;
+    lodOverrideTickInterval = -1.0f;
+    bLODSuspended = false;
+    if (bIgnoreTickLOD || Tier <= 0 || !TierInfo) return;
+
+    const TArray<float>& TierIntervals = GetLODTickIntervals();
+    if (TierIntervals.IsValidIndex(Tier) && TierIntervals[Tier] >= 0.0f) {
+        lodOverrideTickInterval = TierIntervals[Tier];
+    } else {
+        lodTickIntervalScale = TierInfo->TickIntervalScale;
+        lodMinTickInterval = TierInfo->MinTickInterval;
+    }
+
+    for (const auto& Tag : GetTags()) {
+        if (TierInfo->SuspendedTags.Contains(Tag)) {
+            bLODSuspended = true;
+            break;
+        }
     }
 }
 
 void UCapabilityBase::SetEnable(bool bEnable) {
-    if (bCanEverTick == bEnable) return;
-    bCanEverTick = bEnable;
+    if (GetCanEverTick() == bEnable) return;
+    SetCanEverTick(bEnable);
     if (auto Manager = GetCapabilityComponent()) {
         Manager->NotifyShouldUpdateTickStatusNextFrame();
     }
@@ -196,7 +808,15 @@ bool UCapabilityBase::ShouldRunOnThisSide() const {
         return false;
     }
 
-    switch (executeSide) {
+    return ShouldRunOnSide(Owner, GetExecuteSide());
+}
+
+bool UCapabilityBase::ShouldRunOnSide(AActor* Owner, ECapabilityExecuteSide Side) {
+    if (!Owner) return false;
+    UWorld* World = Owner->GetWorld();
+    if (!World) return false;
+
+    switch (Side) {
     case ECapabilityExecuteSide::Always:
         return true;
     case ECapabilityExecuteSide::AuthorityOnly:
@@ -252,8 +872,7 @@ bool UCapabilityBase::ShouldRunOnThisSide() const {
     }
 
     default:
-        UE_LOG(CapabilitySystemLog, Warning, TEXT("Unknown executeSide for %s - %s"),
-               *Owner->GetName(), *GetName());
+        UE_LOG(CapabilitySystemLog, Warning, TEXT("Unknown executeSide for %s"), *Owner->GetName());
         return false;
     }
 }
@@ -0,0 +1,110 @@
+﻿#include "CapabilitySystem/Public/CapabilityBatchTick.h"
+#include "CapabilitySystem/Public/CapabilityBase.h"
+#include "CapabilitySystem/Public/CapabilityComponent.h"
+#include "CapabilitySystem/Public/CapabilitySystemSetting.h"
+
+bool UCapabilityBatchTickSubsystem::ShouldCreateSubsystem(UObject* Outer) const {
+    if (!Super::ShouldCreateSubsystem(Outer)) return false;
+    const UCapabilitySystemSetting* Settings = GetDefault<UCapabilitySystemSetting>();
+    return Settings && Settings->bEnableBatchTick;
+}
+
+void UCapabilityBatchTickSubsystem::Deinitialize() {
+    for (auto& Bucket : Buckets) {
+        for (auto& Entry : Bucket.Entries) {
+            const auto Capability = Entry.Capability.Get();
+            if (!Capability) continue;
+            Capability->BatchBucket = INDEX_NONE;
+            Capability->BatchSlot = INDEX_NONE;
+        }
+    }
+    DEC_DWORD_STAT_BY(STAT_BatchTickingCapabilityCount, NumInstances);
+    Buckets.Reset();
+    BucketIndex.Reset();
+    NumInstances = 0;
+    Super::Deinitialize();
+}
+
+void UCapabilityBatchTickSubsystem::Tick(float DeltaTime) {
+    SCOPE_CYCLE_COUNTER(STAT_Capability_BatchTick);
+
+    bIsTicking = true;
+    // Indexed loops, a tick may register new capabilities and grow these arrays.
+    for (int32 b = 0; b < Buckets.Num(); ++b) {
+        for (int32 i = 0; i < Buckets[b].Entries.Num(); ++i) {
+            const FBatchEntry Entry = Buckets[b].Entries[i];
+            if (Entry.Capability.IsExplicitlyNull()) continue;
+
+            const auto Capability = Entry.Capability.Get();
+            const auto Component = Entry.Component.Get();
+            if (!Capability || !Component) {
+                Buckets[b].Entries[i].Capability = nullptr;
+                NumInstances--;
+                DEC_DWORD_STAT(STAT_BatchTickingCapabilityCount);
+                bHasRemoved = true;
+                continue;
+            }
+
+            // The component toggles its own tick with TickList, the owner tick and activation are the user switches.
+            const AActor* Owner = Component->GetOwner();
+            if (!Component->IsActive() || (Owner && !Owner->IsActorTickEnabled())) continue;
+
+            const float Dilation = Owner ? Owner->CustomTimeDilation : 1.0f;
+            Component->TickDetachedCapability(Capability, DeltaTime * Dilation);
+        }
+    }
+    bIsTicking = false;
+
+    if (bHasRemoved) CompactBuckets();
+}
+
+void UCapabilityBatchTickSubsystem::Register(UCapabilityBase* Capability, UCapabilityComponent* Component) {
+    if (!Capability || !Component || Capability->BatchBucket != INDEX_NONE) return;
+
+    const UClass* Class = Capability->GetClass();
+    int32 Bucket;
+    if (const auto Found = BucketIndex.Find(Class)) {
+        Bucket = *Found;
+    } else {
+        Bucket = Buckets.AddDefaulted();
+        Buckets[Bucket].Class = Class;
+        BucketIndex.Add(Class, Bucket);
+    }
+
+    Capability->BatchBucket = Bucket;
+    Capability->BatchSlot = Buckets[Bucket].Entries.Add(FBatchEntry{Capability, Component});
+    NumInstances++;
+    INC_DWORD_STAT(STAT_BatchTickingCapabilityCount);
+}
+
+void UCapabilityBatchTickSubsystem::Unregister(UCapabilityBase* Capability) {
+    if (!Capability || !Buckets.IsValidIndex(Capability->BatchBucket)) return;
+
+    auto& Entries = Buckets[Capability->BatchBucket].Entries;
+    const int32 Slot = Capability->BatchSlot;
+    Capability->BatchBucket = INDEX_NONE;
+    Capability->BatchSlot = INDEX_NONE;
+    if (!Entries.IsValidIndex(Slot) || Entries[Slot].Capability.Get() != Capability) return;
+
+    NumInstances--;
+    DEC_DWORD_STAT(STAT_BatchTickingCapabilityCount);
+
+    if (bIsTicking) {
+        Entries[Slot].Capability = nullptr;
+        bHasRemoved = true;
+        return;
+    }
+
+    Entries.RemoveAtSwap(Slot);
+    if (Entries.IsValidIndex(Slot)) {
+        if (const auto Moved = Entries[Slot].Capability.Get()) Moved->BatchSlot = Slot;
+    }
+}
+
+void UCapabilityBatchTickSubsystem::CompactBuckets() {
+    bHasRemoved = false;
+    for (auto& Bucket : Buckets) {
+        Bucket.Entries.RemoveAll([](const FBatchEntry& Entry) { return !Entry.Capability.IsValid(); });
+        for (int32 i = 0; i < Bucket.Entries.Num(); ++i) Bucket.Entries[i].Capability->BatchSlot = i;
+    }
+}
@@ -0,0 +1,108 @@
+﻿#include "CapabilitySystem/Public/CapabilityBlockChannel.h"
+#include "CapabilitySystem/Public/CapabilitySystemSetting.h"
+#include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
+
+const FName UCapabilityBlockChannelSubsystem::GlobalChannel(TEXT("Global"));
+
+ACapabilityBlockChannelActor::ACapabilityBlockChannelActor() {
+    bReplicates = true;
+    bAlwaysRelevant = true;
+    PrimaryActorTick.bCanEverTick = false;
+}
+
+void ACapabilityBlockChannelActor::BeginPlay() {
+    Super::BeginPlay();
+    if (const auto World = GetWorld()) {
+        if (const auto Subsystem = World->GetSubsystem<UCapabilityBlockChannelSubsystem>()) {
+            Subsystem->RegisterChannelActor(this);
+        }
+    }
+}
+
+bool ACapabilityBlockChannelActor::AddSource(const FCapabilityChannelBlock& Block, UObject* From) {
+    auto& BlockSources = Sources.FindOrAdd(Block);
+    BlockSources.AddUnique(From);
+    if (BlockSources.Num() > 1) return false;
+
+    Blocks.Add(Block);
+    INC_DWORD_STAT(STAT_CapabilityChannelBlocks);
+    return true;
+}
+
+bool ACapabilityBlockChannelActor::RemoveSource(const FCapabilityChannelBlock& Block, const UObject* From) {
+    auto BlockSources = Sources.Find(Block);
+    if (!BlockSources) return false;
+
+    BlockSources->RemoveAll([From](const TWeakObjectPtr<UObject>& Ptr) {
+        return !Ptr.IsValid() || Ptr.Get() == From;
+    });
+    if (!BlockSources->IsEmpty()) return false;
+
+    Sources.Remove(Block);
+    Blocks.RemoveSingleSwap(Block);
+    DEC_DWORD_STAT(STAT_CapabilityChannelBlocks);
+    return true;
+}
+
+void ACapabilityBlockChannelActor::OnRep_Blocks() {
+    if (const auto World = GetWorld()) {
+        if (const auto Subsystem = World->GetSubsystem<UCapabilityBlockChannelSubsystem>()) {
+            Subsystem->NotifyChannelsChanged();
+        }
+    }
+}
+
+void ACapabilityBlockChannelActor::GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const {
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+    DOREPLIFETIME(ThisClass, Blocks);
+}
+
+bool UCapabilityBlockChannelSubsystem::ShouldCreateSubsystem(UObject* Outer) const {
+    if (!Super::ShouldCreateSubsystem(Outer)) return false;
+    const UCapabilitySystemSetting* Settings = GetDefault<UCapabilitySystemSetting>();
+    return Settings && Settings->bEnableBlockChannels;
+}
+
+void UCapabilityBlockChannelSubsystem::OnWorldBeginPlay(UWorld& InWorld) {
+    Super::OnWorldBeginPlay(InWorld);
+    if (InWorld.GetNetMode() == NM_Client || ChannelActor) return;
+
+    FActorSpawnParameters Params;
+    Params.ObjectFlags |= RF_Transient;
+    Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    RegisterChannelActor(InWorld.SpawnActor<ACapabilityBlockChannelActor>(Params));
+}
+
+void UCapabilityBlockChannelSubsystem::RegisterChannelActor(ACapabilityBlockChannelActor* Actor) {
+    if (!Actor || ChannelActor == Actor) return;
+    ChannelActor = Actor;
+    NotifyChannelsChanged();
+}
+
+void UCapabilityBlockChannelSubsystem::BlockChannel(FName Channel, FName Tag, UObject* From) {
+    if (!IsValid(From)) return;
+    if (!ChannelActor || !ChannelActor->HasAuthority()) {
+        UE_LOG(CapabilitySystemLog, Warning,
+               TEXT("UCapabilityBlockChannelSubsystem::BlockChannel %s:%s ignored, only the server can block channels"),
+               *Channel.ToString(), *Tag.ToString());
+        return;
+    }
+    if (ChannelActor->AddSource(FCapabilityChannelBlock{Channel, Tag}, From)) NotifyChannelsChanged();
+}
+
+void UCapabilityBlockChannelSubsystem::UnBlockChannel(FName Channel, FName Tag, UObject* From) {
+    if (!ChannelActor || !ChannelActor->HasAuthority()) return;
+    if (ChannelActor->RemoveSource(FCapabilityChannelBlock{Channel, Tag}, From)) NotifyChannelsChanged();
+}
+
+bool UCapabilityBlockChannelSubsystem::IsChannelTagBlocked(FName Channel, FName Tag) const {
+    return ChannelActor && ChannelActor->GetBlocks().Contains(FCapabilityChannelBlock{Channel, Tag});
+}
+
+void UCapabilityBlockChannelSubsystem::GatherBlockedTags(const TArray<FName>& Channels, TSet<FName>& OutTags) const {
+    if (!ChannelActor) return;
+    for (const auto& Block : ChannelActor->GetBlocks()) {
+        if (Block.Channel == GlobalChannel || Channels.Contains(Block.Channel)) OutTags.Add(Block.Tag);
+    }
+}
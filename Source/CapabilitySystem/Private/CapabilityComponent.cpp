@@ -2,8 +2,19 @@
 #include "CapabilitySystem/Public/CapabilityAsset.h"
 #include "CapabilitySystem/Public/CapabilityInput.h"
 #include "CapabilitySystem/Public/CapabilityMetaHead.h"
+#include "CapabilitySystem/Public/CapabilityTickBudget.h"
+#include "CapabilitySystem/Public/CapabilityBatchTick.h"
+#include "CapabilitySystem/Public/CapabilityLOD.h"
+#include "CapabilitySystem/Public/CapabilitySystemSetting.h"
+#include "CapabilitySystem/Public/CapabilityTimer.h"
+#include "CapabilitySystem/Public/CapabilityBlockChannel.h"
+#include "CapabilitySystem/Public/CapabilityTeardown.h"
+#include "Async/ParallelFor.h"
 #include "Net/UnrealNetwork.h"
 #include "Net/Core/PushModel/PushModel.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Engine/AssetManager.h"
 #include "GameFramework/PlayerController.h"
 
 UCapabilityComponent::UCapabilityComponent() {
@@ -91,6 +102,18 @@ void UCapabilityComponent::RemoveCapabilitySetCollection(TSoftObjectPtr<UCapabil
 void UCapabilityComponent::BeginPlay() {
     Super::BeginPlay();
 
+    if (const auto World = GetWorld()) {
+        TickBudget = World->GetSubsystem<UCapabilityTickBudgetSubsystem>();
+        BatchTick = World->GetSubsystem<UCapabilityBatchTickSubsystem>();
+        BlockChannelSubsystem = World->GetSubsystem<UCapabilityBlockChannelSubsystem>();
+        if (BlockChannelSubsystem) {
+            BlockChannelSubsystem->OnChannelsChanged.AddUObject(this, &UCapabilityComponent::OnChannelBlocksChanged);
+        }
+        if (bAllowTickLOD) {
+            if (const auto LOD = World->GetSubsystem<UCapabilityLODSubsystem>()) LOD->RegisterComponent(this);
+        }
+    }
+
     if (ComponentMode == ECapabilityComponentMode::Local) {
         for (auto& Collection : CapabilitySetCollection) {
             AddCapabilitySetCollection(Collection);
@@ -114,6 +137,15 @@ void UCapabilityComponent::BeginPlay() {
 
 void UCapabilityComponent::EndPlay(const EEndPlayReason::Type EndPlayReason) {
     bIsShuttingDown = true;
+    CancelAllBlockExpiries();
+    if (BlockChannelSubsystem) BlockChannelSubsystem->OnChannelsChanged.RemoveAll(this);
+    if (LoadoutHandle) {
+        LoadoutHandle->CancelHandle();
+        LoadoutHandle.Reset();
+    }
+    if (const auto World = GetWorld()) {
+        if (const auto LOD = World->GetSubsystem<UCapabilityLODSubsystem>()) LOD->UnregisterComponent(this);
+    }
     if (ComponentMode == ECapabilityComponentMode::Local) {
         RemoveAllCapabilitySet();
     } else {
@@ -121,6 +153,8 @@ void UCapabilityComponent::EndPlay(const EEndPlayReason::Type EndPlayReason) {
             RemoveAllCapabilitySet();
         }
     }
+    RemoveAllLiteCapabilities();
+    EventBus.Reset();
 
     Super::EndPlay(EndPlayReason);
 }
@@ -133,22 +167,344 @@ void UCapabilityComponent::TickComponent(float DeltaTime, ELevelTick TickType,
     if (bNeedSyncClientCaps) SyncCapabilityClient();
     if (bShouldTickUpdateThisFrame) UpdateTickStatus();
 
-    for (const auto& Capability : TickList) {
-        if (Capability) {
-            bool bBlocked = false;
-            if (!BlockInfo.IsEmpty() && !Capability->Tags.IsEmpty()) {
-                for (auto Tag : Capability->Tags) {
-                    if (BlockInfo.Contains(Tag)) { bBlocked = true; break; }
-                }
+    if (EventBus.HasDeferred()) {
+        EventBus.FlushDeferred();
+        // Only kept ticking by PostEvent.
+        if (TickList.IsEmpty() && LiteTickList.IsEmpty() && !bNeedSyncClientCaps && !EventBus.HasDeferred()) {
+            SetComponentTickEnabled(false);
+        }
+    }
+
+    TickCapabilities(DeltaTime, true);
+}
+
+uint64 UCapabilityComponent::GetEventOrder(const UObject* Listener) {
+    const auto Capability = Cast<UCapabilityBase>(Listener);
+    return Capability ? Capability->GetSetOrder() : MAX_uint64;
+}
+
+void UCapabilityComponent::TickCapabilities(float DeltaTime, bool bAllowDeferral) {
+    const bool bUseBudget = bAllowDeferral && TickBudget;
+    const bool bOverBudget = bUseBudget && TickBudget->IsOverBudget();
+    const uint64 BudgetStartCycles = bUseBudget ? FPlatformTime::Cycles64() : 0;
+
+    int32 NextRange = 0;
+    for (int32 i = 0; i < TickList.Num(); ++i) {
+        if (ParallelRanges.IsValidIndex(NextRange) && ParallelRanges[NextRange].Key == i) {
+            ParallelWork.Reset();
+            const int32 End = i + ParallelRanges[NextRange++].Value;
+            for (; i < End; ++i) {
+                float Delta = 0.0f;
+                if (!PrepareCapabilityTick(TickList[i], DeltaTime, bUseBudget, bOverBudget, Delta)) continue;
+                FCapabilityParallelWork Work;
+                Work.Capability = TickList[i];
+                Work.Steps = Work.Capability->PrepareParallelTick(Delta, Work.Delta);
+                if (Work.Steps > 0 && Work.Capability->bIsCapabilityActive) ParallelWork.Add(Work);
             }
+            --i;
+            // Workers look data components up. Serial ticks and activations before this point may have dirtied the
+            // index, rebuild it on the game thread right before handing out the range.
+            EnsureLookupIndex();
+            RunParallelWork();
+            continue;
+        }
 
-            if (bBlocked) {
-                if (Capability->bIsCapabilityActive) Capability->Deactivate();
+        float Delta = 0.0f;
+        if (PrepareCapabilityTick(TickList[i], DeltaTime, bUseBudget, bOverBudget, Delta)) {
+            TickList[i]->NativeTick(Delta);
+        }
+    }
+
+    if (!LiteTickList.IsEmpty()) {
+        const FCapabilityLiteContext Context = MakeLiteContext();
+        for (const auto Lite : LiteTickList) {
+            if (IsTagsBlocked(Lite->Tags)) {
+                Lite->Deactivate(Context);
             } else {
-                Capability->NativeTick(DeltaTime);
+                Lite->NativeTick(Context, DeltaTime);
+            }
+        }
+    }
+
+    if (bUseBudget) TickBudget->ConsumeBudget(FPlatformTime::Cycles64() - BudgetStartCycles);
+}
+
+bool UCapabilityComponent::PrepareCapabilityTick(UCapabilityBase* Capability, float DeltaTime, bool bUseBudget,
+                                                 bool bOverBudget, float& OutDelta) {
+    if (!Capability) return false;
+    if (IsTagsBlocked(Capability->GetTags())) {
+        Capability->deferredTime = 0.0f;
+        if (Capability->bIsCapabilityActive) Capability->Deactivate();
+        return false;
+    }
+    if (Capability->bLODSuspended) return false;
+    if (bOverBudget && TickBudget->ShouldDefer(Capability->GetTickPriority(), Capability->GetUniqueID())) {
+        Capability->deferredTime += DeltaTime;
+        TickBudget->NotifyDeferred();
+        return false;
+    }
+
+    const float DeferredTime = Capability->deferredTime;
+    if (DeferredTime > 0.0f) {
+        Capability->deferredTime = 0.0f;
+        if (bUseBudget) TickBudget->NotifyResumed(DeferredTime);
+    }
+    OutDelta = DeltaTime + DeferredTime;
+    return true;
+}
+
+void UCapabilityComponent::RunParallelWork() {
+    if (ParallelWork.IsEmpty()) return;
+    SCOPE_CYCLE_COUNTER(STAT_Capability_ParallelTick);
+    INC_DWORD_STAT_BY(STAT_ParallelTickedCapabilities, ParallelWork.Num());
+
+    ParallelFor(ParallelWork.Num(), [this](int32 Index) {
+        const FCapabilityParallelWork& Work = ParallelWork[Index];
+#if !UE_BUILD_SHIPPING
+        FCapabilityDataAccessScope AccessScope(Work.Capability);
+#endif
+        for (int32 Step = 0; Step < Work.Steps; ++Step) Work.Capability->TickParallel(Work.Delta);
+    }, ParallelWork.Num() < 2 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+}
+
+void UCapabilityComponent::SaveLoadout(TArray<uint8>& OutData) {
+    FCapabilityLoadout Loadout;
+    auto& Caps = GetSideCapabilityArray();
+    Loadout.Sets.Reserve(Caps.Num());
+
+    for (auto& CapSet : Caps) {
+        auto& Entry = Loadout.Sets.AddDefaulted_GetRef();
+        Entry.Set = CapSet.TargetSet.ToSoftObjectPath();
+        Entry.CapabilityStates.SetNum(CapSet.ObjectRefs.Num());
+        for (int32 i = 0; i < CapSet.ObjectRefs.Num(); i++) {
+            if (!IsValid(CapSet.ObjectRefs[i])) continue;
+            FMemoryWriter Writer(Entry.CapabilityStates[i], true);
+            CapSet.ObjectRefs[i]->SerializeLoadoutState(Writer);
+        }
+    }
+
+    for (const auto& Info : BlockInfo) {
+        // Sources collapse into one block per tag, which only expires if every source was timed.
+        float Duration = 0.0f;
+        for (const auto& Source : Info.From) {
+            const float Remaining = GetBlockRemainingTime(Info.BlockTargetTag, Source.Get());
+            if (Remaining <= 0.0f) {
+                Duration = 0.0f;
+                break;
+            }
+            Duration = FMath::Max(Duration, Remaining);
+        }
+        Loadout.BlockedTags.Add(Info.BlockTargetTag);
+        Loadout.BlockedTagDurations.Add(Duration);
+    }
+
+    Loadout.Write(OutData);
+}
+
+bool UCapabilityComponent::RestoreLoadout(const TArray<uint8>& Data) {
+    if (bIsShuttingDown) return false;
+    if (!PendingLoadout.Read(Data)) {
+        UE_LOG(CapabilitySystemLog, Warning, TEXT("UCapabilityComponent::RestoreLoadout Invalid loadout data on %s"),
+               GetOwner() ? *GetOwner()->GetName() : TEXT("UNKNOWN"));
+        return false;
+    }
+
+    if (LoadoutHandle) {
+        LoadoutHandle->CancelHandle();
+        LoadoutHandle.Reset();
+    }
+
+    TArray<FSoftObjectPath> Paths;
+    for (const auto& Entry : PendingLoadout.Sets) {
+        if (!Entry.Set.IsNull() && !Entry.Set.ResolveObject()) Paths.Add(Entry.Set);
+    }
+
+    if (Paths.IsEmpty()) {
+        ApplyPendingLoadout();
+    } else {
+        LoadoutHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+            MoveTemp(Paths), FStreamableDelegate::CreateUObject(this, &UCapabilityComponent::ApplyPendingLoadout));
+    }
+    return true;
+}
+
+void UCapabilityComponent::ApplyPendingLoadout() {
+    LoadoutHandle.Reset();
+    if (bIsShuttingDown) return;
+
+    for (int32 i = 0; i < PendingLoadout.BlockedTags.Num(); i++) {
+        BlockCapability(PendingLoadout.BlockedTags[i], this, PendingLoadout.BlockedTagDurations[i]);
+    }
+
+    TickStatusBatchDepth++;
+    for (const auto& Entry : PendingLoadout.Sets) {
+        const TSoftObjectPtr<UCapabilitySet> TargetSet(Entry.Set);
+        if (TargetSet.IsNull() || IsCapabilitySetExist(TargetSet)) continue;
+
+        auto& Caps = GetSideCapabilityArray();
+        const int32 PrevNum = Caps.Num();
+        AddCapabilitySet(TargetSet);
+        if (Caps.Num() == PrevNum) continue;
+
+        auto& NewSet = Caps.Last();
+        const int32 StateNum = FMath::Min(NewSet.ObjectRefs.Num(), Entry.CapabilityStates.Num());
+        for (int32 i = 0; i < StateNum; i++) {
+            if (Entry.CapabilityStates[i].IsEmpty() || !IsValid(NewSet.ObjectRefs[i])) continue;
+            FMemoryReader Reader(Entry.CapabilityStates[i], true);
+            NewSet.ObjectRefs[i]->SerializeLoadoutState(Reader);
+        }
+    }
+    TickStatusBatchDepth--;
+
+    PendingLoadout.Reset();
+    UpdateTickStatus();
+    OnLoadoutRestored.Broadcast();
+}
+
+void UCapabilityComponent::ResimulateTick(float DeltaTime) {
+    if (bShouldTickUpdateThisFrame) UpdateTickStatus();
+    TickCapabilities(DeltaTime, false);
+    for (const auto Capability : BatchTickList) {
+        if (Capability) TickDetachedCapability(Capability, DeltaTime);
+    }
+}
+
+void UCapabilityComponent::TickDetachedCapability(UCapabilityBase* Capability, float DeltaTime) {
+    if (IsTagsBlocked(Capability->GetTags())) {
+        if (Capability->bIsCapabilityActive) Capability->Deactivate();
+    } else if (!Capability->bLODSuspended) {
+        Capability->NativeTick(DeltaTime);
+    }
+}
+
+uint32 UCapabilityComponent::ComputeSnapshotTopology() const {
+    const auto& Caps = GetSideCapabilityArray();
+    uint32 Hash = GetTypeHash(Caps.Num());
+    for (const auto& CapSet : Caps) {
+        Hash = HashCombine(Hash, GetTypeHash(CapSet.InstanceID));
+        Hash = HashCombine(Hash, GetTypeHash(CapSet.ObjectRefs.Num()));
+    }
+    return Hash;
+}
+
+void UCapabilityComponent::SerializeBlockInfo(FArchive& Ar) {
+    // Names and weak pointers are copied as raw in-process values, avoiding FName string serialization.
+    int32 Num = BlockInfo.Num();
+    Ar << Num;
+    if (Ar.IsLoading()) BlockInfo.SetNum(Num);
+
+    for (auto& Info : BlockInfo) {
+        Ar.Serialize(&Info.BlockTargetTag, sizeof(FName));
+        int32 FromNum = Info.From.Num();
+        Ar << FromNum;
+        if (Ar.IsLoading()) Info.From.SetNumUninitialized(FromNum);
+        Ar.Serialize(Info.From.GetData(), FromNum * sizeof(TWeakObjectPtr<UObject>));
+    }
+
+    // Timed blocks keep their remaining time, loading re-arms the expiries.
+    const UWorld* World = GetWorld();
+    const auto Timers = World ? World->GetSubsystem<UCapabilityTimerSubsystem>() : nullptr;
+    int32 TimedNum = TimedBlocks.Num();
+    Ar << TimedNum;
+    if (Ar.IsLoading()) {
+        CancelAllBlockExpiries();
+        for (int32 i = 0; i < TimedNum; i++) {
+            FName Tag;
+            TWeakObjectPtr<UObject> From;
+            float Remaining = 0.0f;
+            Ar.Serialize(&Tag, sizeof(FName));
+            Ar.Serialize(&From, sizeof(TWeakObjectPtr<UObject>));
+            Ar << Remaining;
+            if (UObject* Source = From.Get()) SetBlockExpiry(Tag, Source, Remaining);
+        }
+    } else {
+        for (const auto& Pair : TimedBlocks) {
+            FName Tag = Pair.Key.Key;
+            TWeakObjectPtr<UObject> From = Pair.Key.Value;
+            float Remaining = Timers ? Timers->GetBlockRemainingTime(Pair.Value) : 0.0f;
+            Ar.Serialize(&Tag, sizeof(FName));
+            Ar.Serialize(&From, sizeof(TWeakObjectPtr<UObject>));
+            Ar << Remaining;
+        }
+    }
+}
+
+void UCapabilityComponent::SaveStateSnapshot(int32 Frame) {
+    SCOPE_CYCLE_COUNTER(STAT_Capability_SnapshotSave)
+    const auto Setting = GetDefault<UCapabilitySystemSetting>();
+    const int32 Capacity = Setting ? Setting->RollbackSnapshotFrames : 0;
+    if (Capacity <= 0) return;
+
+    FCapabilityStateFrame& Slot = StateSnapshots.Write(Frame, Capacity);
+    Slot.Topology = ComputeSnapshotTopology();
+
+    // Validity flags lead the frame, a restore checks all of them before it touches any capability.
+    FMemoryWriter Writer(Slot.Data);
+    for (auto& CapSet : GetSideCapabilityArray()) {
+        for (auto& Cap : CapSet.ObjectRefs) {
+            bool bValid = IsValid(Cap);
+            Writer << bValid;
+        }
+    }
+    for (auto& CapSet : GetSideCapabilityArray()) {
+        for (auto& Cap : CapSet.ObjectRefs) {
+            if (IsValid(Cap)) Cap->NativeSerializeRollbackState(Writer);
+        }
+    }
+    SerializeBlockInfo(Writer);
+    StateSnapshots.UpdateMemoryStat();
+}
+
+bool UCapabilityComponent::RestoreStateSnapshot(int32 Frame) {
+    SCOPE_CYCLE_COUNTER(STAT_Capability_SnapshotRestore)
+    const FCapabilityStateFrame* Slot = StateSnapshots.Find(Frame);
+    if (!Slot) return false;
+
+    if (Slot->Topology != ComputeSnapshotTopology()) {
+        UE_LOG(CapabilitySystemLog, Warning,
+               TEXT("UCapabilityComponent::RestoreStateSnapshot Capability sets changed since frame %d on %s"),
+               Frame, GetOwner() ? *GetOwner()->GetName() : TEXT("UNKNOWN"));
+        return false;
+    }
+
+    FMemoryReader Reader(Slot->Data);
+    TArray<bool, TInlineAllocator<64>> ValidFlags;
+    for (auto& CapSet : GetSideCapabilityArray()) {
+        for (auto& Cap : CapSet.ObjectRefs) {
+            bool bValid = false;
+            Reader << bValid;
+            if (bValid && !IsValid(Cap)) {
+                UE_LOG(CapabilitySystemLog, Warning,
+                       TEXT("UCapabilityComponent::RestoreStateSnapshot Capability of frame %d is gone on %s"),
+                       Frame, GetOwner() ? *GetOwner()->GetName() : TEXT("UNKNOWN"));
+                return false;
             }
+            ValidFlags.Add(bValid);
+        }
+    }
+
+    int32 FlagIndex = 0;
+    for (auto& CapSet : GetSideCapabilityArray()) {
+        for (auto& Cap : CapSet.ObjectRefs) {
+            if (ValidFlags[FlagIndex++]) Cap->NativeSerializeRollbackState(Reader);
         }
     }
+
+    TArray<FName, TInlineAllocator<8>> PreviousTags;
+    for (const auto& Info : BlockInfo) PreviousTags.Add(Info.BlockTargetTag);
+    SerializeBlockInfo(Reader);
+    if (GetOwner() && GetOwner()->HasAuthority()) MARK_PROPERTY_DIRTY_FROM_NAME(ThisClass, BlockInfo, this);
+    OnBlockInfoChanged.Broadcast();
+
+    // Same as BlockCapability, a tag blocked by the restored frame but not before ends its active capabilities.
+    TArray<FName, TInlineAllocator<8>> NewTags;
+    for (const auto& Info : BlockInfo) {
+        if (!PreviousTags.Contains(Info.BlockTargetTag)) NewTags.Add(Info.BlockTargetTag);
+    }
+    for (const auto& Tag : NewTags) DeactivateCapabilitiesWithTag(Tag);
+
+    StateSnapshots.DiscardAfter(Frame);
+    return !Reader.IsError();
 }
 
 void UCapabilityComponent::OnControllerChanged(APlayerController* NewController, UEnhancedInputComponent* InputComponent) {
@@ -162,11 +518,9 @@ void UCapabilityComponent::OnControllerChanged(APlayerController* NewController,
     auto& Capabilities = GetSideCapabilityArray();
 
     for (auto& CapSet : Capabilities) {
-        for (auto& Cap : CapSet.ObjectRefs) {
-            if (UCapabilityInput* InputCap = Cast<UCapabilityInput>(Cap)) {
-                if (IsValid(InputCap))
-                    InputCap->OnGetControllerAndInputComponent(CachedController, CachedInputComponent);
-            }
+        for (auto& InputCap : CapSet.InputRefs) {
+            if (IsValid(InputCap))
+                InputCap->OnGetControllerAndInputComponent(CachedController, CachedInputComponent);
         }
     }
 }
@@ -177,10 +531,8 @@ void UCapabilityComponent::OnControllerRemoved() {
     const auto& Capabilities = GetSideCapabilityArray();
 
     for (auto& Cap : Capabilities) {
-        for (int i = Cap.ObjectRefs.Num() - 1; i >= 0; --i) {
-            if (UCapabilityInput* InputCap = Cast<UCapabilityInput>(Cap.ObjectRefs[i])) {
-                InputCap->OnMissingController();
-            }
+        for (int i = Cap.InputRefs.Num() - 1; i >= 0; --i) {
+            if (Cap.InputRefs[i]) Cap.InputRefs[i]->OnMissingController();
         }
     }
 
@@ -188,117 +540,498 @@ void UCapabilityComponent::OnControllerRemoved() {
     CachedInputComponent = nullptr;
 }
 
+void UCapabilityComponent::RecordInputEvent(const UInputAction* Action, ETriggerEvent TriggerEvent,
+                                            const FInputActionValue& Value) {
+    const UWorld* World = GetWorld();
+    if (!Action || !World) return;
+
+    const auto Setting = GetDefault<UCapabilitySystemSetting>();
+    const int32 Capacity = Setting->InputBufferCapacity;
+    if (Capacity <= 0 || !Setting->InputBufferTriggerEvents.Contains(TriggerEvent)) return;
+
+    // Several capabilities may bind the same action, keep one event per frame.
+    if (auto Latest = InputBuffer.FindLatest(Action, TriggerEvent, World->GetTimeSeconds(), true)) {
+        if (Latest->Frame == GFrameCounter) return;
+    }
+
+    FCapabilityInputEvent Event;
+    Event.Action = Action;
+    Event.TriggerEvent = TriggerEvent;
+    Event.Value = Value;
+    Event.WorldTime = World->GetTimeSeconds();
+    Event.Frame = GFrameCounter;
+    InputBuffer.Push(Event, Capacity);
+}
+
+bool UCapabilityComponent::WasInputTriggeredWithin(const UInputAction* Action, float WithinSeconds,
+                                                   ETriggerEvent TriggerEvent) const {
+    const UWorld* World = GetWorld();
+    if (!Action || !World || InputBuffer.IsEmpty()) return false;
+    return InputBuffer.FindLatest(Action, TriggerEvent, World->GetTimeSeconds() - WithinSeconds, false) != nullptr;
+}
+
+bool UCapabilityComponent::ConsumeInput(const UInputAction* Action, float WithinSeconds, FCapabilityInputEvent& OutEvent,
+                                        ETriggerEvent TriggerEvent) {
+    const UWorld* World = GetWorld();
+    if (!Action || !World || InputBuffer.IsEmpty()) return false;
+
+    auto Event = InputBuffer.FindLatest(Action, TriggerEvent, World->GetTimeSeconds() - WithinSeconds, false);
+    if (!Event) return false;
+    Event->bConsumed = true;
+    OutEvent = *Event;
+    return true;
+}
+
+void UCapabilityComponent::ReleaseCapabilitySets(TArray<FCapabilityObjectRefSet>& Sets) {
+    UCapabilityTeardownSubsystem* Teardown = nullptr;
+    if (bIsShuttingDown && bAllowDeferredTeardown) {
+        if (const auto World = GetWorld()) Teardown = World->GetSubsystem<UCapabilityTeardownSubsystem>();
+    }
+
+    if (Teardown) {
+        // Same order as the immediate path below.
+        TArray<UObject*, TInlineAllocator<32>> Objects;
+        for (int m = Sets.Num() - 1; m >= 0; --m) {
+            auto& CapabilitySet = Sets[m];
+            for (int i = CapabilitySet.ComponentRefs.Num() - 1; i >= 0; --i) {
+                if (CapabilitySet.ComponentRefs[i]) Objects.Add(CapabilitySet.ComponentRefs[i]);
+            }
+        }
+        for (int m = Sets.Num() - 1; m >= 0; --m) {
+            auto& CapabilitySet = Sets[m];
+            for (int i = CapabilitySet.ObjectRefs.Num() - 1; i >= 0; --i) {
+                if (CapabilitySet.ObjectRefs[i]) Objects.Add(CapabilitySet.ObjectRefs[i]);
+            }
+            if (CapabilitySet.MetaHead) Objects.Add(CapabilitySet.MetaHead);
+        }
+        Teardown->Enqueue(Objects);
+        return;
+    }
+
+    for (int m = Sets.Num() - 1; m >= 0; --m) {
+        auto& CapabilitySet = Sets[m];
+        for (int i = CapabilitySet.ComponentRefs.Num() - 1; i >= 0; --i) {
+            if (CapabilitySet.ComponentRefs[i]) CapabilitySet.ComponentRefs[i]->DestroyComponent();
+        }
+    }
+    for (int m = Sets.Num() - 1; m >= 0; --m) { Sets[m].MarkGC(); }
+}
+
 void UCapabilityComponent::UpdateTickStatus() {
+    bLookupIndexDirty = true;
+    if (TickStatusBatchDepth > 0) {
+        bShouldTickUpdateThisFrame = true;
+        return;
+    }
     DEC_DWORD_STAT_BY(STAT_TickingCapabilityCount, TickList.Num());
     TickList.Reset();
     bShouldTickUpdateThisFrame = false;
 
     const auto& Caps = GetSideCapabilityArray();
 
+    const auto Setting = GetDefault<UCapabilitySystemSetting>();
+    const float FixedStep = FixedTimestepOverride > 0.0f ? FixedTimestepOverride : (Setting ? Setting->FixedTimestep : 0.0f);
+    const int32 MaxSubsteps = MaxFixedSubstepsOverride > 0 ? MaxFixedSubstepsOverride : (Setting ? Setting->MaxFixedSubsteps : 1);
+
+    BatchTickList.Reset();
+    ParallelRanges.Reset();
+
+    const bool bParallelTick = Setting && Setting->bParallelCapabilityTick;
+    // (tick layer, capability) of the current set.
+    TArray<TPair<int32, UCapabilityBase*>, TInlineAllocator<32>> SetTicking;
+
     for (const auto& CapSet : Caps) {
-        for (auto Cap : CapSet.ObjectRefs) {
-            if (Cap && Cap->bCanEverTick && Cap->ShouldRunOnThisSide()) {
-                TickList.Add(Cap);
+        const UCapabilitySet* SetPtr = bParallelTick ? CapSet.TargetSet.Get() : nullptr;
+        const TArray<int32>* Layers = SetPtr ? &SetPtr->GetTickLayers() : nullptr;
+        SetTicking.Reset();
+
+        for (const auto Cap : CapSet.ObjectRefs) {
+            if (!IsValid(Cap)) continue;
+            if (Cap->GetCanEverTick() && Cap->ShouldRunOnThisSide()) {
+                Cap->ApplyLODTier(LODTier, LODTierInfo);
+                Cap->ApplyFixedTimestep(bForceFixedTimestep || Cap->GetUseFixedTimestep() ? FixedStep : 0.0f, MaxSubsteps);
+                if (BatchTick && Cap->GetBatchTick()) {
+                    BatchTick->Register(Cap, this);
+                    BatchTickList.Add(Cap);
+                } else {
+                    if (BatchTick) BatchTick->Unregister(Cap);
+                    SetTicking.Emplace(Layers && Layers->IsValidIndex(Cap->IndexInSet) ? (*Layers)[Cap->IndexInSet] : 0, Cap);
+                }
+            } else if (BatchTick) {
+                BatchTick->Unregister(Cap);
             }
         }
+
+        if (!Layers) {
+            for (const auto& Pair : SetTicking) TickList.Add(Pair.Value);
+            continue;
+        }
+
+        // Layer by layer, serial members first, then the parallel ones as one range.
+        SetTicking.StableSort([](const TPair<int32, UCapabilityBase*>& A, const TPair<int32, UCapabilityBase*>& B) {
+            return A.Key < B.Key;
+        });
+        for (int32 Start = 0; Start < SetTicking.Num();) {
+            int32 End = Start + 1;
+            while (End < SetTicking.Num() && SetTicking[End].Key == SetTicking[Start].Key) ++End;
+
+            for (int32 k = Start; k < End; ++k) {
+                if (!SetTicking[k].Value->GetParallelTick()) TickList.Add(SetTicking[k].Value);
+            }
+            const int32 RangeStart = TickList.Num();
+            for (int32 k = Start; k < End; ++k) {
+                if (SetTicking[k].Value->GetParallelTick()) TickList.Add(SetTicking[k].Value);
+            }
+            if (TickList.Num() > RangeStart) ParallelRanges.Emplace(RangeStart, TickList.Num() - RangeStart);
+            Start = End;
+        }
     }
+
+    LiteTickList.Reset();
+    for (auto& LiteSet : LiteCapabilitySets) {
+        for (int i = 0; i < LiteSet.Capabilities.Num(); i++) {
+            auto Lite = LiteSet.Capabilities[i].GetPtr<FCapabilityLite>();
+            if (Lite && Lite->ShouldTick()) LiteTickList.Add(Lite);
+        }
+    }
+
     INC_DWORD_STAT_BY(STAT_TickingCapabilityCount, TickList.Num());
-    SetComponentTickEnabled(!TickList.IsEmpty() || bNeedSyncClientCaps);
+    SetComponentTickEnabled(!TickList.IsEmpty() || !LiteTickList.IsEmpty() || bNeedSyncClientCaps ||
+                            EventBus.HasDeferred());
 }
 
-void UCapabilityComponent::BlockCapability(const FName& Tag, UObject* From) {
-    if (!IsValid(From)) return;
-    if (bIsShuttingDown) return;
-    if (ComponentMode == ECapabilityComponentMode::Local) {
-        for (auto& TagInfo : BlockInfo) {
-            if (TagInfo.BlockTargetTag == Tag) {
-                TagInfo.From.AddUnique(From);
-                return;
-            }
+bool UCapabilityComponent::IsTagsBlocked(const TArray<FName>& Tags) const {
+    if (Tags.IsEmpty()) return false;
+    if (!BlockInfo.IsEmpty()) {
+        for (const auto& Tag : Tags) {
+            if (BlockInfo.Contains(Tag)) return true;
         }
-        BlockInfo.Emplace(Tag, TArray<TWeakObjectPtr<UObject>>{TWeakObjectPtr<UObject>(From)});
+    }
+    return IsChannelTagBlocked(Tags);
+}
+
+bool UCapabilityComponent::IsChannelTagBlocked(const TArray<FName>& Tags) const {
+    if (!BlockChannelSubsystem || !BlockChannelSubsystem->HasAnyBlocks()) return false;
+
+    if (ChannelRevision != BlockChannelSubsystem->GetRevision()) RefreshChannelBlockedTags();
+
+    if (ChannelBlockedTags.IsEmpty()) return false;
+    for (const auto& Tag : Tags) {
+        if (ChannelBlockedTags.Contains(Tag)) return true;
+    }
+    return false;
+}
+
+void UCapabilityComponent::RefreshChannelBlockedTags() const {
+    ChannelRevision = BlockChannelSubsystem->GetRevision();
+    ChannelBlockedTags.Reset();
+    BlockChannelSubsystem->GatherBlockedTags(BlockChannels, ChannelBlockedTags);
+}
+
+void UCapabilityComponent::OnChannelBlocksChanged() {
+    if (bIsShuttingDown || !BlockChannelSubsystem || !BlockChannelSubsystem->HasAnyBlocks()) return;
+    RefreshChannelBlockedTags();
+
+    // Same as BlockCapability. Tags blocked before have no active capabilities left, only new blocks end any.
+    const TArray<FName> Tags = ChannelBlockedTags.Array();
+    for (const auto& Tag : Tags) DeactivateCapabilitiesWithTag(Tag);
+}
+
+bool UCapabilityComponent::CanChangeBlockChannels(const FName& Channel) const {
+    if (ComponentMode == ECapabilityComponentMode::Local || !GetOwner() || GetOwner()->HasAuthority()) return true;
+    UE_LOG(CapabilitySystemLog, Warning,
+           TEXT("UCapabilityComponent::JoinBlockChannel / LeaveBlockChannel %s ignored on %s, only the server can change channels"),
+           *Channel.ToString(), *GetOwner()->GetName());
+    return false;
+}
+
+void UCapabilityComponent::JoinBlockChannel(FName Channel) {
+    if (Channel.IsNone() || BlockChannels.Contains(Channel) || !CanChangeBlockChannels(Channel)) return;
+    BlockChannels.Add(Channel);
+    MARK_PROPERTY_DIRTY_FROM_NAME(ThisClass, BlockChannels, this);
+    OnRep_BlockChannels();
+}
+
+void UCapabilityComponent::LeaveBlockChannel(FName Channel) {
+    if (!BlockChannels.Contains(Channel) || !CanChangeBlockChannels(Channel)) return;
+    BlockChannels.Remove(Channel);
+    MARK_PROPERTY_DIRTY_FROM_NAME(ThisClass, BlockChannels, this);
+    OnRep_BlockChannels();
+}
+
+void UCapabilityComponent::OnRep_BlockChannels() {
+    // Regathers the channel blocked tags on the next block check.
+    ChannelRevision = 0;
+    OnChannelBlocksChanged();
+    OnBlockInfoChanged.Broadcast();
+}
+
+void UCapabilityComponent::CreateLiteCapabilities(uint32 InstanceID, const UCapabilitySet* SetPtr) {
+    if (!SetPtr || SetPtr->LiteCapabilities.IsEmpty()) return;
+
+    TArray<FInstancedStruct> ValidLites{};
+    ValidLites.Reserve(SetPtr->LiteCapabilities.Num());
+    for (const auto& Lite : SetPtr->LiteCapabilities) {
+        if (Lite.GetPtr<FCapabilityLite>()) {
+            ValidLites.Add(Lite);
+        } else {
+            UE_LOG(CapabilitySystemLog, Error,
+                   TEXT("UCapabilityComponent::CreateLiteCapabilities Invalid Lite Capability in Set %s, at %s - %s"),
+                   *SetPtr->GetName(), *GetName(), GetOwner() ? *GetOwner()->GetName() : TEXT("Unknown"));
+        }
+    }
+
+    FCapabilityLiteSet& LiteSet = LiteCapabilitySets.Emplace_GetRef();
+    LiteSet.InstanceID = InstanceID;
+    LiteSet.Capabilities.Append(ValidLites);
+    LiteSet.CallBeginPlay(MakeLiteContext());
+}
+
+void UCapabilityComponent::RemoveLiteCapabilities(uint32 InstanceID) {
+    const int32 Index = LiteCapabilitySets.IndexOfByPredicate([InstanceID](const FCapabilityLiteSet& LiteSet) {
+        return LiteSet.InstanceID == InstanceID;
+    });
+    if (Index == INDEX_NONE) return;
+
+    const FCapabilityLiteContext Context = MakeLiteContext();
+    LiteCapabilitySets[Index].CallPreEndPlay(Context);
+    LiteCapabilitySets[Index].CallEndPlay(Context);
+    LiteCapabilitySets.RemoveAt(Index);
+}
+
+void UCapabilityComponent::RemoveAllLiteCapabilities() {
+    if (LiteCapabilitySets.IsEmpty()) return;
+
+    auto MovedArray = MoveTemp(LiteCapabilitySets);
+    LiteTickList.Reset();
+
+    const FCapabilityLiteContext Context = MakeLiteContext();
+    for (int m = MovedArray.Num() - 1; m >= 0; --m) { MovedArray[m].CallPreEndPlay(Context); }
+    for (int m = MovedArray.Num() - 1; m >= 0; --m) { MovedArray[m].CallEndPlay(Context); }
+}
+
+const FCapabilityLiteSet* UCapabilityComponent::FindLiteCapabilities(uint32 InstanceID) const {
+    return LiteCapabilitySets.FindByPredicate([InstanceID](const FCapabilityLiteSet& LiteSet) {
+        return LiteSet.InstanceID == InstanceID;
+    });
+}
+
+void UCapabilityComponent::SetLODTier(int32 Tier, const FCapabilityLODTier* TierInfo) {
+    if (LODTier == Tier) return;
+    LODTier = Tier;
+    LODTierInfo = TierInfo;
+    if (bShouldTickUpdateThisFrame) {
+        UpdateTickStatus();
         return;
     }
-    if (GetOwner() && GetOwner()->HasAuthority()) {
-        for (auto& TagInfo : BlockInfo) {
-            if (TagInfo.BlockTargetTag == Tag) {
-                TagInfo.From.AddUnique(From);
-                MARK_PROPERTY_DIRTY_FROM_NAME(ThisClass, BlockInfo, this);
-                return;
+    for (const auto& Capability : TickList) {
+        if (Capability) Capability->ApplyLODTier(LODTier, LODTierInfo);
+    }
+    for (const auto& Capability : BatchTickList) {
+        if (Capability) Capability->ApplyLODTier(LODTier, LODTierInfo);
+    }
+}
+
+bool UCapabilityComponent::AddBlockSource(const FName& Tag, UObject* From) {
+    for (auto& TagInfo : BlockInfo) {
+        if (TagInfo.BlockTargetTag == Tag) {
+            TagInfo.From.AddUnique(From);
+            return false;
+        }
+    }
+    BlockInfo.Emplace(Tag, TArray<TWeakObjectPtr<UObject>>{TWeakObjectPtr<UObject>(From)});
+    return true;
+}
+
+void UCapabilityComponent::DeactivateCapabilitiesWithTag(const FName& Tag) {
+    // Copied first, OnDeactivate may add or remove sets or tags and rebuild the tag index under the loop.
+    TArray<UCapabilityBase*, TInlineAllocator<8>> Matches;
+    for (const auto& Weak : FindCapabilitiesByTag(Tag)) {
+        UCapabilityBase* Capability = Weak.Get();
+        if (Capability && Capability->bIsCapabilityActive) Matches.Add(Capability);
+    }
+    for (const auto Capability : Matches) {
+        if (!IsValid(Capability) || !Capability->bIsCapabilityActive) continue;
+        Capability->deferredTime = 0.0f;
+        Capability->Deactivate();
+    }
+}
+
+bool UCapabilityComponent::RemoveBlockSource(const FName& Tag, const UObject* From) {
+    for (int i = BlockInfo.Num() - 1; i >= 0; --i) {
+        auto& Info = BlockInfo[i];
+        if (Info.BlockTargetTag == Tag) {
+            const int32 Removed = Info.From.RemoveAll([From](const TWeakObjectPtr<UObject>& Ptr) {
+                return !Ptr.IsValid() || Ptr.Get() == From;
+            });
+            if (Info.From.IsEmpty()) {
+                BlockInfo.RemoveAt(i);
+                OnBlockInfoChanged.Broadcast();
+                return true;
             }
+            return Removed > 0;
         }
+    }
+    return false;
+}
 
-        BlockInfo.Emplace(Tag, TArray<TWeakObjectPtr<UObject>>{TWeakObjectPtr<UObject>(From)});
+void UCapabilityComponent::BlockCapability(const FName& Tag, UObject* From, float Duration) {
+    if (!IsValid(From)) return;
+    if (bIsShuttingDown) return;
+    if (ComponentMode == ECapabilityComponentMode::Local) {
+        SetBlockExpiry(Tag, From, Duration);
+        if (AddBlockSource(Tag, From)) DeactivateCapabilitiesWithTag(Tag);
+        return;
+    }
+    if (GetOwner() && GetOwner()->HasAuthority()) {
+        SetBlockExpiry(Tag, From, Duration);
+        const bool bNewTag = AddBlockSource(Tag, From);
         MARK_PROPERTY_DIRTY_FROM_NAME(ThisClass, BlockInfo, this);
+        if (bNewTag) DeactivateCapabilitiesWithTag(Tag);
     } else {
-        ServerBlockCapability(Tag, From);
-        for (auto& TagInfo : BlockInfo) {
-            if (TagInfo.BlockTargetTag == Tag) {
-                TagInfo.From.AddUnique(From);
-                return;
+        ServerBlockCapability(Tag, From, Duration);
+        // Predicted locally, the server expiry replicates the authoritative state.
+        SetBlockExpiry(Tag, From, Duration);
+        if (AddBlockSource(Tag, From)) DeactivateCapabilitiesWithTag(Tag);
+    }
+}
+
+void UCapabilityComponent::SetBlockExpiry(const FName& Tag, UObject* From, float Duration) {
+    const UWorld* World = GetWorld();
+    const auto Timers = World ? World->GetSubsystem<UCapabilityTimerSubsystem>() : nullptr;
+
+    const FTimedBlockKey Key(Tag, From);
+    if (auto Existing = TimedBlocks.Find(Key)) {
+        if (Timers) Timers->CancelBlockExpiry(*Existing);
+        TimedBlocks.Remove(Key);
+    }
+
+    if (Duration <= 0.0f || !Timers) return;
+    TimedBlocks.Add(Key, Timers->ScheduleBlockExpiry(this, Tag, From, Duration));
+}
+
+void UCapabilityComponent::CancelAllBlockExpiries() {
+    if (TimedBlocks.IsEmpty()) return;
+    const UWorld* World = GetWorld();
+    if (const auto Timers = World ? World->GetSubsystem<UCapabilityTimerSubsystem>() : nullptr) {
+        for (auto& Pair : TimedBlocks) Timers->CancelBlockExpiry(Pair.Value);
+    }
+    TimedBlocks.Reset();
+}
+
+void UCapabilityComponent::OnTimedBlockExpired(const FName& Tag, const TWeakObjectPtr<UObject>& From) {
+    TimedBlocks.Remove(FTimedBlockKey(Tag, From));
+    if (!RemoveBlockSource(Tag, From.Get())) return;
+    if (ComponentMode != ECapabilityComponentMode::Local && GetOwner() && GetOwner()->HasAuthority()) {
+        MARK_PROPERTY_DIRTY_FROM_NAME(ThisClass, BlockInfo, this);
+    }
+}
+
+float UCapabilityComponent::GetBlockRemainingTime(FName Tag, UObject* From) const {
+    const auto Handle = TimedBlocks.Find(FTimedBlockKey(Tag, From));
+    const UWorld* World = GetWorld();
+    const auto Timers = World ? World->GetSubsystem<UCapabilityTimerSubsystem>() : nullptr;
+    return Handle && Timers ? Timers->GetBlockRemainingTime(*Handle) : 0.0f;
+}
+
+void UCapabilityComponent::EnsureLookupIndex() const {
+    if (!bLookupIndexDirty) return;
+    // Parallel ticks only read the index, which the game thread rebuilds before each range.
+    if (!ensureMsgf(IsInGameThread(), TEXT("UCapabilityComponent lookup index dirtied during a parallel tick"))) return;
+    bLookupIndexDirty = false;
+
+    // Keep the map and array allocations, tags rarely change between rebuilds.
+    for (auto& Pair : TagIndex) Pair.Value.Reset();
+    CapabilityClassIndex.Reset();
+    DataComponentClassIndex.Reset();
+
+    for (const auto& CapSet : GetSideCapabilityArray()) {
+        for (const auto& Cap : CapSet.ObjectRefs) {
+            if (!IsValid(Cap)) continue;
+            for (const auto& Tag : Cap->GetTags()) {
+                TagIndex.FindOrAdd(Tag).Add(Cap);
+            }
+            for (const UClass* Class = Cap->GetClass(); Class && Class != UCapabilityBase::StaticClass();
+                 Class = Class->GetSuperClass()) {
+                if (!CapabilityClassIndex.Contains(Class)) CapabilityClassIndex.Add(Class, Cap);
+            }
+        }
+        for (const auto& Comp : CapSet.ComponentRefs) {
+            if (!IsValid(Comp)) continue;
+            for (const UClass* Class = Comp->GetClass(); Class && Class != UCapabilityDataComponent::StaticClass();
+                 Class = Class->GetSuperClass()) {
+                if (!DataComponentClassIndex.Contains(Class)) DataComponentClassIndex.Add(Class, Comp);
             }
         }
-        BlockInfo.Emplace(Tag, TArray<TWeakObjectPtr<UObject>>{TWeakObjectPtr<UObject>(From)});
+    }
+}
+
+UCapabilityBase* UCapabilityComponent::FindCapabilityByClass(TSubclassOf<UCapabilityBase> Class) const {
+    if (!Class) return nullptr;
+    EnsureLookupIndex();
+    const auto Found = CapabilityClassIndex.Find(Class.Get());
+    return Found ? Found->Get() : nullptr;
+}
+
+UCapabilityDataComponent* UCapabilityComponent::GetDataComponentByClass(TSubclassOf<UCapabilityDataComponent> Class) const {
+    return FindDataComponent(Class.Get(), false);
+}
+
+UCapabilityDataComponent* UCapabilityComponent::GetDataComponentForWrite(TSubclassOf<UCapabilityDataComponent> Class) const {
+    return FindDataComponent(Class.Get(), true);
+}
+
+UCapabilityDataComponent* UCapabilityComponent::FindDataComponent(const UClass* Class, bool bWrite) const {
+    if (!Class) return nullptr;
+#if !UE_BUILD_SHIPPING
+    if (const auto Accessor = FCapabilityDataAccessScope::GetCurrent()) Accessor->ValidateDataAccess(Class, bWrite);
+#endif
+    EnsureLookupIndex();
+    const auto Found = DataComponentClassIndex.Find(Class);
+    return Found ? Found->Get() : nullptr;
+}
+
+TConstArrayView<TWeakObjectPtr<UCapabilityBase>> UCapabilityComponent::FindCapabilitiesByTag(FName Tag) const {
+    EnsureLookupIndex();
+    if (const auto Found = TagIndex.Find(Tag)) return *Found;
+    return {};
+}
+
+bool UCapabilityComponent::IsAnyActiveWithTag(FName Tag) const {
+    for (const auto& Weak : FindCapabilitiesByTag(Tag)) {
+        const UCapabilityBase* Capability = Weak.Get();
+        if (Capability && Capability->IsCapabilityActive()) return true;
+    }
+    return false;
+}
+
+void UCapabilityComponent::GetCapabilitiesByTag(FName Tag, TArray<UCapabilityBase*>& OutCapabilities) const {
+    const TConstArrayView<TWeakObjectPtr<UCapabilityBase>> Found = FindCapabilitiesByTag(Tag);
+    OutCapabilities.Reset(Found.Num());
+    for (const auto& Weak : Found) {
+        if (UCapabilityBase* Capability = Weak.Get()) OutCapabilities.Add(Capability);
     }
 }
 
 void UCapabilityComponent::UnBlockCapability(const FName& Tag, UObject* From) {
     if (!IsValid(From)) return;
+    if (!TimedBlocks.IsEmpty()) SetBlockExpiry(Tag, From, 0.0f);
     if (ComponentMode == ECapabilityComponentMode::Local) {
-        for (int i = BlockInfo.Num() - 1; i >= 0; --i) {
-            auto& Info = BlockInfo[i];
-            if (Info.BlockTargetTag == Tag) {
-                Info.From.RemoveAll([From](const TWeakObjectPtr<UObject>& Ptr) {
-                    return !Ptr.IsValid() || Ptr.Get() == From;
-                });
-                if (Info.From.IsEmpty()) {
-                    BlockInfo.RemoveAt(i);
-                    break;
-                }
-            }
-        }
+        RemoveBlockSource(Tag, From);
         return;
     }
     if (GetOwner() && GetOwner()->HasAuthority()) {
-        int Changed = 0;
-        for (int i = BlockInfo.Num() - 1; i >= 0; --i) {
-            auto& Info = BlockInfo[i];
-            if (Info.BlockTargetTag == Tag) {
-                Changed += Info.From.RemoveAll([From](const TWeakObjectPtr<UObject>& Ptr) {
-                    return !Ptr.IsValid() || Ptr.Get() == From;
-                });
-
-                if (Info.From.IsEmpty()) {
-                    Changed++;
-                    BlockInfo.RemoveAt(i);
-                    break;
-                }
-            }
-        }
-
-        if (Changed > 0) {
+        if (RemoveBlockSource(Tag, From)) {
             MARK_PROPERTY_DIRTY_FROM_NAME(ThisClass, BlockInfo, this);
         }
     } else {
         ServerUnBlockCapability(Tag, From);
-        for (int i = BlockInfo.Num() - 1; i >= 0; --i) {
-            auto& Info = BlockInfo[i];
-            if (Info.BlockTargetTag == Tag) {
-                Info.From.RemoveAll([From](const TWeakObjectPtr<UObject>& Ptr) {
-                    return !Ptr.IsValid() || Ptr.Get() == From;
-                });
-
-                if (Info.From.IsEmpty()) {
-                    BlockInfo.RemoveAt(i);
-                    break;
-                }
-            }
-        }
+        RemoveBlockSource(Tag, From);
     }
 }
 
-void UCapabilityComponent::ServerBlockCapability_Implementation(const FName& Tag, UObject* From) {
-    BlockCapability(Tag, From);
+void UCapabilityComponent::ServerBlockCapability_Implementation(const FName& Tag, UObject* From, float Duration) {
+    BlockCapability(Tag, From, Duration);
 }
 
 void UCapabilityComponent::ServerUnBlockCapability_Implementation(const FName& Tag, UObject* From) {
@@ -313,11 +1046,9 @@ void UCapabilityComponent::UpdateInputCapabilities() {
     const auto& Caps = GetSideCapabilityArray();
 
     for (auto& CapSet : Caps) {
-        for (auto Cap : CapSet.ObjectRefs) {
-            if (UCapabilityInput* InputCap = Cast<UCapabilityInput>(Cap)) {
-                if (InputCap->ShouldRunOnThisSide()) {
-                    InputCap->OnGetControllerAndInputComponent(CachedController, CachedInputComponent);
-                }
+        for (auto InputCap : CapSet.InputRefs) {
+            if (InputCap && InputCap->ShouldRunOnThisSide()) {
+                InputCap->OnGetControllerAndInputComponent(CachedController, CachedInputComponent);
             }
         }
     }
@@ -331,15 +1062,14 @@ void UCapabilityComponent::SyncCapabilityClient() {
 
     int AdditionNum = 0;
 
-    for (auto& Capability : ToRemoveCollect) { ToAddCollect.Remove(Capability); }
+    for (const uint32 InstanceID : ToRemoveCollect) { ToAddCollect.Remove(InstanceID); }
 
     int RemoveCount = CapabilitiesOnClient.RemoveAll([this](const FCapabilityObjectRefSet& Capability) {
-        if (ToRemoveCollect.Contains(Capability)) {
+        if (ToRemoveCollect.Contains(Capability.InstanceID)) {
+            RemoveLiteCapabilities(Capability.InstanceID);
             if (CachedController) {
-                for (int i = Capability.ObjectRefs.Num() - 1; i >= 0; --i) {
-                    if (UCapabilityInput* InputCap = Cast<UCapabilityInput>(Capability.ObjectRefs[i])) {
-                        InputCap->OnMissingController();
-                    }
+                for (int i = Capability.InputRefs.Num() - 1; i >= 0; --i) {
+                    if (Capability.InputRefs[i]) Capability.InputRefs[i]->OnMissingController();
                 }
             }
             return true;
@@ -349,11 +1079,17 @@ void UCapabilityComponent::SyncCapabilityClient() {
 
     ToRemoveCollect.Reset();
 
-    TSet<FCapabilityObjectRefSet> NotReadyAdd;
+    TSet<uint32> NotReadyAdd;
+
+    for (const uint32 InstanceID : ToAddCollect) {
+        const FCapabilityObjectRefSet* Found = CapabilitySetListOnServer.FindByPredicate(
+            [InstanceID](const FCapabilityObjectRefSet& Set) { return Set.InstanceID == InstanceID; });
+        if (!Found) continue;
 
-    for (auto& Capability : ToAddCollect) {
+        const FCapabilityObjectRefSet& Capability = *Found;
         if (Capability.MetaHead) {
             auto Ready = true;
+            TArray<TObjectPtr<UCapabilityDataComponent>> FoundComps;
 
             for (auto i : Capability.ClassOfComponents) {
                 if (!IsValid(i)) {
@@ -365,7 +1101,7 @@ void UCapabilityComponent::SyncCapabilityClient() {
                     break;
                 }
 
-                auto Comp = GetOwner() ? GetOwner()->GetComponentByClass(i) : nullptr;
+                auto Comp = GetOwner() ? Cast<UCapabilityDataComponent>(GetOwner()->GetComponentByClass(i)) : nullptr;
                 if (!Comp) {
                     UE_LOG(CapabilitySystemLog, Warning,
                            TEXT("UCapabilityComponent::SyncCapabilityClient Find Missing Component %s on %s"),
@@ -378,14 +1114,32 @@ void UCapabilityComponent::SyncCapabilityClient() {
                     Ready = false;
                     break;
                 }
+                FoundComps.Add(Comp);
+            }
+
+            if (Ready) {
+                for (const auto& Class : Capability.MetaHead->ClientOnlyClasses) {
+                    if (!IsValid(Class)) {
+                        Ready = false;
+                        break;
+                    }
+                }
             }
 
             if (Ready) {
-                CapabilitiesOnClient.Add(Capability);
-                Capability.CallBeginPlay();
+                const UCapabilitySet* SetPtr = Capability.TargetSet.LoadSynchronous();
+                if (SetPtr) {
+                    for (auto& Ref : Capability.ObjectRefs) SetPtr->ApplySetConfig(Ref);
+                }
+                auto& ClientSet = CapabilitiesOnClient.Add_GetRef(Capability);
+                SpawnClientOnlyCapabilities(ClientSet, SetPtr);
+                ClientSet.ComponentRefs = MoveTemp(FoundComps);
+                ClientSet.CacheInputRefs();
+                ClientSet.CallBeginPlay();
+                CreateLiteCapabilities(Capability.InstanceID, SetPtr);
                 AdditionNum++;
             } else {
-                NotReadyAdd.Add(Capability);
+                NotReadyAdd.Add(InstanceID);
             }
         }
     }
@@ -407,29 +1161,67 @@ void UCapabilityComponent::SyncCapabilityClient() {
 }
 
 
-void UCapabilityComponent::OnRep_CapabilitySetListOnServer() {
-    if (!GetOwner() || GetOwner()->HasAuthority()) return;
+bool UCapabilityComponent::IsClientOnlyCapabilityClass(TSubclassOf<UCapabilityBase> Class) {
+    if (!Class) return false;
+    // Every other side can hold on a dedicated server, LocalControlledOnly for example runs there for AI pawns.
+    if (Class.GetDefaultObject()->GetExecuteSide() != ECapabilityExecuteSide::AllClients) return false;
 
-    for (auto& Cap : LastClientCapabilities) {
-        if (!CapabilitySetListOnServer.Contains(Cap)) {
-            ToRemoveCollect.Add(Cap);
+    // A client spawned capability has no server counterpart, its server / multicast RPCs would go nowhere.
+    for (TFieldIterator<UFunction> It(Class); It; ++It) {
+        if (!It->HasAnyFunctionFlags(FUNC_Net)) continue;
+
+        static TSet<TObjectKey<UClass>> Reported;
+        bool bAlreadyReported = false;
+        Reported.Add(Class.Get(), &bAlreadyReported);
+        if (!bAlreadyReported) {
+            UE_LOG(CapabilitySystemLog, Warning,
+                   TEXT("UCapabilityComponent::IsClientOnlyCapabilityClass %s declares the RPC %s, not stripped on the dedicated server"),
+                   *Class->GetName(), *It->GetName());
         }
+        return false;
+    }
+    return true;
+}
+
+void UCapabilityComponent::SpawnClientOnlyCapabilities(FCapabilityObjectRefSet& ClientSet, const UCapabilitySet* SetPtr) {
+    UCapabilityMetaHead* MetaHead = ClientSet.MetaHead;
+    if (!MetaHead || MetaHead->ClientOnlyClasses.IsEmpty()) return;
+
+    const int32 Num = FMath::Min(MetaHead->ClientOnlyClasses.Num(), MetaHead->ClientOnlyIndices.Num());
+    for (int32 i = 0; i < Num; ++i) {
+        auto NewCapability = NewObject<UCapabilityBase>(this, MetaHead->ClientOnlyClasses[i]);
+        NewCapability->TargetCapabilityComponent = this;
+        NewCapability->TargetMetaHead = MetaHead;
+        NewCapability->IndexInSet = MetaHead->ClientOnlyIndices[i];
+        if (SetPtr) SetPtr->ApplySetConfig(NewCapability);
+        MetaHead->LocalCapabilities.Add(NewCapability);
+        ClientSet.ObjectRefs.Add(NewCapability);
     }
 
+    ClientSet.ObjectRefs.StableSort([](const TObjectPtr<UCapabilityBase>& A, const TObjectPtr<UCapabilityBase>& B) {
+        return (A ? A->IndexInSet : 0) < (B ? B->IndexInSet : 0);
+    });
+}
+
+void UCapabilityComponent::OnRep_CapabilitySetListOnServer() {
+    if (!GetOwner() || GetOwner()->HasAuthority()) return;
+
+    TSet<uint32> ServerIDs;
+    ServerIDs.Reserve(CapabilitySetListOnServer.Num());
     for (const auto& Cap : CapabilitySetListOnServer) {
-        if (!LastClientCapabilities.Contains(Cap)) {
-            ToAddCollect.Add(Cap);
-        }
+        ServerIDs.Add(Cap.InstanceID);
     }
 
-    for (auto& Cap : ToAddCollect) {
-        LastClientCapabilities.Add(Cap);
+    for (const uint32 InstanceID : LastClientCapabilities) {
+        if (!ServerIDs.Contains(InstanceID)) ToRemoveCollect.Add(InstanceID);
     }
 
-    for (auto& Cap : ToRemoveCollect) {
-        LastClientCapabilities.Remove(Cap);
+    for (const uint32 InstanceID : ServerIDs) {
+        if (!LastClientCapabilities.Contains(InstanceID)) ToAddCollect.Add(InstanceID);
     }
 
+    LastClientCapabilities = MoveTemp(ServerIDs);
+
     bNeedSyncClientCaps = true;
     SetComponentTickEnabled(true);
 }
@@ -503,11 +1295,13 @@ void UCapabilityComponent::AddCapabilitySet(TSoftObjectPtr<UCapabilitySet> Targe
                 break;
             }
             NewCapability->TargetCapabilityComponent = this;
+            NewCapability->IndexInSet = NewCapabilityObjects.Num();
+            Ptr->ApplySetConfig(NewCapability);
             NewCapabilityObjects.Emplace(NewCapability);
         }
 
         if (CreateSuccess) {
-            if (NewCapabilityObjects.IsEmpty()) return;
+            if (NewCapabilityObjects.IsEmpty() && Ptr->LiteCapabilities.IsEmpty()) return;
 
             FCapabilityObjectRefSet& TempSet = LocalCapabilities.Emplace_GetRef();
             TempSet.TargetSet = TargetSet;
@@ -526,13 +1320,13 @@ void UCapabilityComponent::AddCapabilitySet(TSoftObjectPtr<UCapabilitySet> Targe
                 TempSet.ObjectRefs.Add(Capability);
             }
 
+            TempSet.CacheInputRefs();
             TempSet.CallBeginPlay();
+            CreateLiteCapabilities(TempSet.InstanceID, Ptr);
 
             if (CachedController && CachedInputComponent) {
-                for (auto& Capability : NewCapabilityObjects) {
-                    if (UCapabilityInput* InputCap = Cast<UCapabilityInput>(Capability)) {
-                        InputCap->OnGetControllerAndInputComponent(CachedController, CachedInputComponent);
-                    }
+                for (auto& InputCap : TempSet.InputRefs) {
+                    InputCap->OnGetControllerAndInputComponent(CachedController, CachedInputComponent);
                 }
             }
 
@@ -620,7 +1414,18 @@ void UCapabilityComponent::AddCapabilitySet(TSoftObjectPtr<UCapabilitySet> Targe
 
     TArray<TObjectPtr<UCapabilityBase>> NewCapabilityObjects{};
 
-    for (const auto& Capability : Ptr->ClassOfCapability) {
+    const auto Setting = GetDefault<UCapabilitySystemSetting>();
+    const bool bStripClientOnly = Setting && Setting->bStripClientOnlyCapabilities
+        && TheOwner->GetNetMode() == NM_DedicatedServer;
+
+    for (int32 i = 0; i < Ptr->ClassOfCapability.Num(); ++i) {
+        const auto& Capability = Ptr->ClassOfCapability[i];
+        if (bStripClientOnly && IsClientOnlyCapabilityClass(Capability)) {
+            MetaHead->ClientOnlyClasses.Add(Capability);
+            MetaHead->ClientOnlyIndices.Add(static_cast<int16>(i));
+            continue;
+        }
+
         auto NewCapability = NewObject<UCapabilityBase>(this, Capability);
         if (!NewCapability) {
             UE_LOG(CapabilitySystemLog, Error,
@@ -633,11 +1438,13 @@ void UCapabilityComponent::AddCapabilitySet(TSoftObjectPtr<UCapabilitySet> Targe
 
         NewCapability->TargetCapabilityComponent = this;
         NewCapability->TargetMetaHead = MetaHead;
+        NewCapability->IndexInSet = i;
+        Ptr->ApplySetConfig(NewCapability);
         NewCapabilityObjects.Emplace(NewCapability);
     }
 
     if (CreateSuccess) {
-        if (NewCapabilityObjects.IsEmpty()) return;
+        if (NewCapabilityObjects.IsEmpty() && MetaHead->ClientOnlyClasses.IsEmpty() && Ptr->LiteCapabilities.IsEmpty()) return;
 
         FCapabilityObjectRefSet& TempSet = CapabilitySetListOnServer.Emplace_GetRef();
         TempSet.TargetSet = TargetSet;
@@ -660,13 +1467,13 @@ void UCapabilityComponent::AddCapabilitySet(TSoftObjectPtr<UCapabilitySet> Targe
         }
         AddReplicatedSubObject(MetaHead);
 
+        TempSet.CacheInputRefs();
         TempSet.CallBeginPlay();
+        CreateLiteCapabilities(TempSet.InstanceID, Ptr);
 
         if (CachedController && CachedInputComponent) {
-            for (auto& Capability : NewCapabilityObjects) {
-                if (UCapabilityInput* InputCap = Cast<UCapabilityInput>(Capability)) {
-                    InputCap->OnGetControllerAndInputComponent(CachedController, CachedInputComponent);
-                }
+            for (auto& InputCap : TempSet.InputRefs) {
+                InputCap->OnGetControllerAndInputComponent(CachedController, CachedInputComponent);
             }
         }
 
@@ -707,13 +1514,12 @@ void UCapabilityComponent::RemoveCapabilitySet(TSoftObjectPtr<UCapabilitySet> Ta
         auto CapabilitySetRef = LocalCapabilities[FindIndex];
 
         if (CachedController) {
-            for (int i = CapabilitySetRef.ObjectRefs.Num() - 1; i >= 0; --i) {
-                if (UCapabilityInput* InputCap = Cast<UCapabilityInput>(CapabilitySetRef.ObjectRefs[i])) {
-                    InputCap->OnMissingController();
-                }
+            for (int i = CapabilitySetRef.InputRefs.Num() - 1; i >= 0; --i) {
+                if (CapabilitySetRef.InputRefs[i]) CapabilitySetRef.InputRefs[i]->OnMissingController();
             }
         }
 
+        RemoveLiteCapabilities(CapabilitySetRef.InstanceID);
         CapabilitySetRef.CallPreEndPlay();
         CapabilitySetRef.CallEndPlay();
 
@@ -760,13 +1566,13 @@ void UCapabilityComponent::RemoveCapabilitySet(TSoftObjectPtr<UCapabilitySet> Ta
     auto CapabilitySetRef = CapabilitySetListOnServer[FindIndex];
 
     if (CachedController) {
-        for (int i = CapabilitySetRef.ObjectRefs.Num() - 1; i >= 0; --i) {
-            if (UCapabilityInput* InputCap = Cast<UCapabilityInput>(CapabilitySetRef.ObjectRefs[i])) {
-                InputCap->OnMissingController();
-            }
+        for (int i = CapabilitySetRef.InputRefs.Num() - 1; i >= 0; --i) {
+            if (CapabilitySetRef.InputRefs[i]) CapabilitySetRef.InputRefs[i]->OnMissingController();
         }
     }
 
+    RemoveLiteCapabilities(CapabilitySetRef.InstanceID);
+
     CapabilitySetRef.CallPreEndPlay();
 
     CapabilitySetRef.CallEndPlay();
@@ -814,25 +1620,18 @@ void UCapabilityComponent::RemoveAllCapabilitySet() {
         if (CachedController) {
             for (int m = MovedArray.Num() - 1; m >= 0; --m) {
                 auto& CapabilitySet = MovedArray[m];
-                for (int i = CapabilitySet.ObjectRefs.Num() - 1; i >= 0; --i) {
-                    if (UCapabilityInput* InputCap = Cast<UCapabilityInput>(CapabilitySet.ObjectRefs[i])) {
-                        InputCap->OnMissingController();
-                    }
+                for (int i = CapabilitySet.InputRefs.Num() - 1; i >= 0; --i) {
+                    if (CapabilitySet.InputRefs[i]) CapabilitySet.InputRefs[i]->OnMissingController();
                 }
             }
         }
 
+        RemoveAllLiteCapabilities();
+
         for (int m = MovedArray.Num() - 1; m >= 0; --m) { MovedArray[m].CallPreEndPlay(); }
         for (int m = MovedArray.Num() - 1; m >= 0; --m) { MovedArray[m].CallEndPlay(); }
 
-        for (int m = MovedArray.Num() - 1; m >= 0; --m) {
-            auto& CapabilitySet = MovedArray[m];
-            for (int i = CapabilitySet.ComponentRefs.Num() - 1; i >= 0; --i) {
-                if (CapabilitySet.ComponentRefs[i]) CapabilitySet.ComponentRefs[i]->DestroyComponent();
-            }
-        }
-
-        for (int m = MovedArray.Num() - 1; m >= 0; --m) { MovedArray[m].MarkGC(); }
+        ReleaseCapabilitySets(MovedArray);
 
         UpdateTickStatus();
         return;
@@ -852,14 +1651,14 @@ void UCapabilityComponent::RemoveAllCapabilitySet() {
     if (CachedController) {
         for (int m = MovedArray.Num() - 1; m >= 0; --m) {
             auto& CapabilitySet = MovedArray[m];
-            for (int i = CapabilitySet.ObjectRefs.Num() - 1; i >= 0; --i) {
-                if (UCapabilityInput* InputCap = Cast<UCapabilityInput>(CapabilitySet.ObjectRefs[i])) {
-                    InputCap->OnMissingController();
-                }
+            for (int i = CapabilitySet.InputRefs.Num() - 1; i >= 0; --i) {
+                if (CapabilitySet.InputRefs[i]) CapabilitySet.InputRefs[i]->OnMissingController();
             }
         }
     }
 
+    RemoveAllLiteCapabilities();
+
     for (int m = MovedArray.Num() - 1; m >= 0; --m) {
         MovedArray[m].CallPreEndPlay();
     }
@@ -876,16 +1675,7 @@ void UCapabilityComponent::RemoveAllCapabilitySet() {
         RemoveReplicatedSubObject(CapabilitySet.MetaHead);
     }
 
-    for (int m = MovedArray.Num() - 1; m >= 0; --m) {
-        auto& CapabilitySet = MovedArray[m];
-        for (int i = CapabilitySet.ComponentRefs.Num() - 1; i >= 0; --i) {
-            if (CapabilitySet.ComponentRefs[i]) CapabilitySet.ComponentRefs[i]->DestroyComponent();
-        }
-    }
-
-    for (int m = MovedArray.Num() - 1; m >= 0; --m) {
-        MovedArray[m].MarkGC();
-    }
+    ReleaseCapabilitySets(MovedArray);
 
     UpdateTickStatus();
 
@@ -921,12 +1711,25 @@ void UCapabilityComponent::GetCapabilityComponentStates(TArray<FCapabilitySetSta
         for (const auto& Cap : CapSet.ObjectRefs) {
             FCapabilityState CapState{};
             CapState.CapName = Cap->GetName();
-            CapState.CanEverTick = Cap->bCanEverTick;
+            CapState.CanEverTick = Cap->GetCanEverTick();
             CapState.ExecSide = Cap->GetExecuteSide();
             CapState.ShouldRunOnThisSide = Cap->ShouldRunOnThisSide();
             CapState.IsActive = Cap->bIsCapabilityActive;
             State.States.Add(CapState);
         }
+        if (const FCapabilityLiteSet* LiteSet = FindLiteCapabilities(CapSet.InstanceID)) {
+            for (int i = 0; i < LiteSet->Capabilities.Num(); i++) {
+                const auto Lite = LiteSet->Capabilities[i].GetPtr<FCapabilityLite>();
+                if (!Lite) continue;
+                FCapabilityState CapState{};
+                CapState.CapName = LiteSet->Capabilities[i].GetScriptStruct()->GetName();
+                CapState.CanEverTick = Lite->bCanEverTick;
+                CapState.ExecSide = Lite->ExecuteSide;
+                CapState.ShouldRunOnThisSide = Lite->ShouldRunOnThisSide();
+                CapState.IsActive = Lite->IsCapabilityActive();
+                State.States.Add(CapState);
+            }
+        }
         OutStates.Add(State);
     }
 }
@@ -939,9 +1742,11 @@ void UCapabilityComponent::GetLifetimeReplicatedProps(TArray<class FLifetimeProp
     SharedParams.RepNotifyCondition = REPNOTIFY_Always;
     DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, CapabilitySetListOnServer, SharedParams);
     DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, BlockInfo, SharedParams);
+    DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, BlockChannels, SharedParams);
 }
 
 void UCapabilityComponent::NotifyShouldUpdateTickStatusNextFrame() {
     bShouldTickUpdateThisFrame = true;
+    bLookupIndexDirty = true;
     SetComponentTickEnabled(true);
 }
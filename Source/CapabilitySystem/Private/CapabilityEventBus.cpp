@@ -0,0 +1,206 @@
+﻿#include "CapabilitySystem/Public/CapabilityEventBus.h"
+
+namespace {
+    struct FChannelNames {
+        FRWLock Lock;
+
+        TArray<FName> Names;
+    };
+
+    FChannelNames& GetChannelNames() {
+        static FChannelNames Channels;
+        return Channels;
+    }
+}
+
+int32 FCapabilityEventRegistry::Register(FName Name) {
+    FChannelNames& Channels = GetChannelNames();
+    FWriteScopeLock Lock(Channels.Lock);
+    const int32 Existing = Channels.Names.IndexOfByKey(Name);
+    return Existing != INDEX_NONE ? Existing : Channels.Names.Add(Name);
+}
+
+FName FCapabilityEventRegistry::GetChannelName(int32 Id) {
+    FChannelNames& Channels = GetChannelNames();
+    FReadScopeLock Lock(Channels.Lock);
+    return Channels.Names.IsValidIndex(Id) ? Channels.Names[Id] : NAME_None;
+}
+
+FCapabilityEventSubscription FCapabilityEventBus::AddSubscriber(int32 Channel, const UObject* Listener, uint64 Order,
+                                                                TFunction<void(const void*)>&& Handler) {
+    if (Channel < 0 || !Handler) return FCapabilityEventSubscription();
+
+    FSubscriber Subscriber;
+    Subscriber.Id = NextSubscriberId++;
+    Subscriber.Order = Order;
+    Subscriber.Listener = Listener;
+    Subscriber.Handler = MoveTemp(Handler);
+
+    FCapabilityEventSubscription Subscription;
+    Subscription.Channel = Channel;
+    Subscription.Id = Subscriber.Id;
+
+    if (DispatchDepth > 0) PendingSubscribers.Emplace(Channel, MoveTemp(Subscriber));
+    else InsertSubscriber(Channel, MoveTemp(Subscriber));
+    return Subscription;
+}
+
+void FCapabilityEventBus::InsertSubscriber(int32 Channel, FSubscriber&& Subscriber) {
+    if (Subscribers.Num() <= Channel) Subscribers.SetNum(Channel + 1);
+    auto& List = Subscribers[Channel];
+
+    // After the subscribers of the same order, equal orders keep their subscription order.
+    int32 Index = List.Num();
+    while (Index > 0 && List[Index - 1].Order > Subscriber.Order) --Index;
+    List.Insert(MoveTemp(Subscriber), Index);
+    UpdateMemoryStat();
+}
+
+void FCapabilityEventBus::Dispatch(int32 Channel, const void* Payload) {
+    if (!Subscribers.IsValidIndex(Channel) || Subscribers[Channel].IsEmpty()) return;
+    SCOPE_CYCLE_COUNTER(STAT_Capability_EventDispatch);
+    INC_DWORD_STAT(STAT_CapabilityEventsSent);
+
+    ++DispatchDepth;
+    // Not resized while dispatching, new subscribers are pending and removed ones only flagged.
+    for (auto& Subscriber : Subscribers[Channel]) {
+        if (Subscriber.bRemoved || !Subscriber.Listener.IsValid()) continue;
+        Subscriber.Handler(Payload);
+    }
+    if (--DispatchDepth > 0) return;
+
+    if (bPendingReset) {
+        if (!bIsFlushing) FinishPendingReset();
+        return;
+    }
+    if (bHasRemoved) {
+        bHasRemoved = false;
+        for (auto& List : Subscribers) {
+            List.RemoveAll([](const FSubscriber& Subscriber) { return Subscriber.bRemoved; });
+        }
+    }
+    if (!PendingSubscribers.IsEmpty()) {
+        auto Pending = MoveTemp(PendingSubscribers);
+        for (auto& Pair : Pending) InsertSubscriber(Pair.Key, MoveTemp(Pair.Value));
+    }
+}
+
+void FCapabilityEventBus::Unsubscribe(FCapabilityEventSubscription& Subscription) {
+    const uint64 Id = Subscription.Id;
+    const int32 Channel = Subscription.Channel;
+    Subscription.Invalidate();
+    if (Id == 0) return;
+
+    if (PendingSubscribers.RemoveAll([Id](const TPair<int32, FSubscriber>& Pair) { return Pair.Value.Id == Id; }) > 0) {
+        return;
+    }
+    if (!Subscribers.IsValidIndex(Channel)) return;
+
+    auto& List = Subscribers[Channel];
+    const int32 Index = List.IndexOfByPredicate([Id](const FSubscriber& Subscriber) { return Subscriber.Id == Id; });
+    if (Index == INDEX_NONE) return;
+
+    if (DispatchDepth > 0) {
+        List[Index].bRemoved = true;
+        bHasRemoved = true;
+    } else {
+        List.RemoveAt(Index);
+    }
+}
+
+void FCapabilityEventBus::UnsubscribeAll(const UObject* Listener) {
+    PendingSubscribers.RemoveAll([Listener](const TPair<int32, FSubscriber>& Pair) {
+        return Pair.Value.Listener.Get() == Listener;
+    });
+
+    for (auto& List : Subscribers) {
+        for (int32 i = List.Num() - 1; i >= 0; --i) {
+            if (List[i].Listener.Get() != Listener) continue;
+            if (DispatchDepth > 0) {
+                List[i].bRemoved = true;
+                bHasRemoved = true;
+            } else {
+                List.RemoveAt(i);
+            }
+        }
+    }
+}
+
+void* FCapabilityEventBus::AllocDeferred(int32 Channel, int32 Size, int32 Alignment, void (*Destroy)(void*)) {
+    // TArray storage is at least 16 byte aligned, offsets only need the payload alignment.
+    const int32 Offset = Align(Queued.Bytes.Num(), Alignment);
+    const int32 OldMax = Queued.Bytes.Max();
+    Queued.Bytes.SetNumUninitialized(Offset + Size);
+    Queued.Events.Add(FQueuedEvent{Channel, Offset, Destroy});
+    if (Queued.Bytes.Max() != OldMax) UpdateMemoryStat();
+    return Queued.Bytes.GetData() + Offset;
+}
+
+void FCapabilityEventBus::FlushDeferred() {
+    if (bIsFlushing || Queued.Events.IsEmpty()) return;
+    bIsFlushing = true;
+
+    // Handlers may post again, those events go to the other queue and keep these payloads in place.
+    Swap(Queued, Flushing);
+    for (const auto& Event : Flushing.Events) {
+        if (bPendingReset) break;
+        Dispatch(Event.Channel, Flushing.Bytes.GetData() + Event.Offset);
+    }
+    Flushing.Clear();
+
+    bIsFlushing = false;
+    if (bPendingReset && DispatchDepth == 0) FinishPendingReset();
+}
+
+void FCapabilityEventBus::FEventQueue::Clear() {
+    for (const auto& Event : Events) Event.Destroy(Bytes.GetData() + Event.Offset);
+    Events.Reset();
+    Bytes.Reset();
+}
+
+void FCapabilityEventBus::Reset() {
+    if (DispatchDepth > 0 || bIsFlushing) {
+        // The subscriber lists and the flushed payloads are still being iterated.
+        for (auto& List : Subscribers) {
+            for (auto& Subscriber : List) Subscriber.bRemoved = true;
+        }
+        bHasRemoved = true;
+        PendingSubscribers.Reset();
+        Queued.Clear();
+        bPendingReset = true;
+        return;
+    }
+
+    bPendingReset = false;
+    bHasRemoved = false;
+    Queued.Clear();
+    Flushing.Clear();
+    Subscribers.Empty();
+    PendingSubscribers.Empty();
+    Queued.Bytes.Empty();
+    Queued.Events.Empty();
+    Flushing.Bytes.Empty();
+    Flushing.Events.Empty();
+    UpdateMemoryStat();
+}
+
+void FCapabilityEventBus::FinishPendingReset() {
+    auto Pending = MoveTemp(PendingSubscribers);
+    Reset();
+    for (auto& Pair : Pending) InsertSubscriber(Pair.Key, MoveTemp(Pair.Value));
+}
+
+SIZE_T FCapabilityEventBus::GetAllocatedSize() const {
+    SIZE_T Size = Subscribers.GetAllocatedSize() + PendingSubscribers.GetAllocatedSize();
+    for (const auto& List : Subscribers) Size += List.GetAllocatedSize();
+    Size += Queued.Bytes.GetAllocatedSize() + Queued.Events.GetAllocatedSize();
+    Size += Flushing.Bytes.GetAllocatedSize() + Flushing.Events.GetAllocatedSize();
+    return Size;
+}
+
+void FCapabilityEventBus::UpdateMemoryStat() {
+    const SIZE_T Size = GetAllocatedSize();
+    DEC_MEMORY_STAT_BY(STAT_CapabilityEventBusMemory, ReportedMemory);
+    INC_MEMORY_STAT_BY(STAT_CapabilityEventBusMemory, Size);
+    ReportedMemory = Size;
+}
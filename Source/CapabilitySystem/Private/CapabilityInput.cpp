@@ -1,4 +1,6 @@
 ﻿#include "CapabilitySystem/Public/CapabilityInput.h"
+#include "CapabilitySystem/Public/CapabilityComponent.h"
+#include "CapabilitySystem/Public/CapabilitySystemSetting.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 
@@ -96,11 +98,108 @@ bool UCapabilityInput::BindAction(const UInputAction* Action, ETriggerEvent Trig
         return false;
     }
 
+    // Bound first so the handler below already sees this event in the component input buffer.
+    BindInputRecorder(Action);
+
     auto& Handle = CachedInputComponent->BindAction(Action, TriggerEvent, Target, FunctionName);
     ActionRecords.Add(Handle.GetHandle());
     return true;
 }
 
+bool UCapabilityInput::BindActivationAction(const UInputAction* Action, ETriggerEvent TriggerEvent) {
+    if (!IsValid(Action)) {
+        UE_LOGFMT(CapabilitySystemLog, Error,
+                  "UCapabilityInput::BindActivationAction - TObjectPtr<UInputAction> Action is null {0} - {1}",
+                  GetOwner() ? *GetOwner()->GetName() : TEXT("Unknown"), *GetName());
+        return false;
+    }
+
+    if (!CachedInputComponent) {
+        UE_LOGFMT(CapabilitySystemLog, Error, "UCapabilityInput::BindActivationAction - TryGetEnhanceInputComponent Failed {0} - {1}",
+                  GetOwner() ? *GetOwner()->GetName() : TEXT("Unknown"), *GetName());
+        return false;
+    }
+
+    BindInputRecorder(Action);
+    auto& Handle = CachedInputComponent->BindAction(Action, TriggerEvent, this, &UCapabilityInput::OnActivationActionTriggered);
+    ActionRecords.Add(Handle.GetHandle());
+    return true;
+}
+
+void UCapabilityInput::BindInputRecorder(const UInputAction* Action) {
+    const auto Setting = GetDefault<UCapabilitySystemSetting>();
+    if (Setting->InputBufferCapacity <= 0 || RecordedActions.Contains(Action)) return;
+    RecordedActions.Add(Action);
+
+    for (const ETriggerEvent Event : Setting->InputBufferTriggerEvents) {
+        auto& Handle = CachedInputComponent->BindAction(Action, Event, this, &UCapabilityInput::OnBufferedActionTriggered);
+        ActionRecords.Add(Handle.GetHandle());
+    }
+}
+
+void UCapabilityInput::OnActivationActionTriggered(const FInputActionInstance& Instance) {
+    WakeUpActionInstance = Instance;
+    WakeUp();
+}
+
+void UCapabilityInput::OnBufferedActionTriggered(const FInputActionInstance& Instance) {
+    if (auto Comp = GetCapabilityComponent())
+        Comp->RecordInputEvent(Instance.GetSourceAction(), Instance.GetTriggerEvent(), Instance.GetValue());
+}
+
+FCapabilityTaskHandle UCapabilityInput::WaitInput(const UInputAction* Action, ETriggerEvent TriggerEvent,
+                                                 FCapabilityTaskDelegate Then) {
+    FCapabilityTask Task;
+    Task.Delegate = MoveTemp(Then);
+    return StartInputTask(Action, TriggerEvent, MoveTemp(Task));
+}
+
+FCapabilityTaskHandle UCapabilityInput::WaitInput(const UInputAction* Action, ETriggerEvent TriggerEvent,
+                                                 TFunction<void()>&& Then) {
+    FCapabilityTask Task;
+    Task.Then = MoveTemp(Then);
+    return StartInputTask(Action, TriggerEvent, MoveTemp(Task));
+}
+
+FCapabilityTaskHandle UCapabilityInput::StartInputTask(const UInputAction* Action, ETriggerEvent TriggerEvent,
+                                                      FCapabilityTask&& Task) {
+    if (!IsValid(Action)) {
+        UE_LOGFMT(CapabilitySystemLog, Error,
+                  "UCapabilityInput::WaitInput - TObjectPtr<UInputAction> Action is null {0} - {1}",
+                  GetOwner() ? *GetOwner()->GetName() : TEXT("Unknown"), *GetName());
+        return FCapabilityTaskHandle();
+    }
+
+    if (!CachedInputComponent) {
+        UE_LOGFMT(CapabilitySystemLog, Error, "UCapabilityInput::WaitInput - TryGetEnhanceInputComponent Failed {0} - {1}",
+                  GetOwner() ? *GetOwner()->GetName() : TEXT("Unknown"), *GetName());
+        return FCapabilityTaskHandle();
+    }
+
+    return StartTask(MoveTemp(Task), [this, Action, TriggerEvent](uint64 Id) -> TFunction<void()> {
+        UEnhancedInputComponent* InputComponent = CachedInputComponent;
+        const uint32 Binding = InputComponent->BindAction(Action, TriggerEvent, this,
+                                                          &UCapabilityInput::OnTaskActionTriggered).GetHandle();
+        InputWaits.Add(FInputWait{Id, Action, TriggerEvent});
+
+        return [this, Id, Binding, WeakInput = TWeakObjectPtr<UEnhancedInputComponent>(InputComponent)] {
+            if (const auto Input = WeakInput.Get()) Input->RemoveBindingByHandle(Binding);
+            InputWaits.RemoveAllSwap([Id](const FInputWait& Wait) { return Wait.TaskId == Id; });
+        };
+    });
+}
+
+void UCapabilityInput::OnTaskActionTriggered(const FInputActionInstance& Instance) {
+    // Resuming unbinds the wait and may start new ones, collect first.
+    TArray<uint64, TInlineAllocator<4>> Resumed;
+    for (const auto& Wait : InputWaits) {
+        if (Wait.Action == Instance.GetSourceAction() && Wait.TriggerEvent == Instance.GetTriggerEvent()) {
+            Resumed.Add(Wait.TaskId);
+        }
+    }
+    for (const uint64 Id : Resumed) ResumeTask(Id);
+}
+
 bool UCapabilityInput::BindInputMappingContext(const UInputMappingContext* Context, int32 IMC_Priority) {
     if (Context == nullptr) {
         UE_LOGFMT(CapabilitySystemLog, Error,
@@ -197,5 +296,6 @@ void UCapabilityInput::UnBindInputActions() {
     }
 
     ActionRecords.Reset();
+    RecordedActions.Reset();
     bIsBoundActions = false;
 }
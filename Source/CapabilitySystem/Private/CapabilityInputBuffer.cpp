@@ -0,0 +1,45 @@
+﻿#include "CapabilitySystem/Public/CapabilityInputBuffer.h"
+
+void FCapabilityInputBuffer::Push(const FCapabilityInputEvent& Event, int32 Capacity) {
+    if (Capacity <= 0) return;
+    if (Events.Num() != Capacity) {
+        Events.SetNum(Capacity);
+        Head = 0;
+        Count = 0;
+    }
+
+    Events[Head] = Event;
+    Head = (Head + 1) % Capacity;
+    Count = FMath::Min(Count + 1, Capacity);
+}
+
+int32 FCapabilityInputBuffer::FindLatestIndex(const UInputAction* Action, ETriggerEvent TriggerEvent,
+                                              double MinWorldTime, bool bIncludeConsumed) const {
+    const int32 Capacity = Events.Num();
+    for (int32 i = 0; i < Count; i++) {
+        const int32 Index = (Head - 1 - i + Capacity) % Capacity;
+        const FCapabilityInputEvent& Event = Events[Index];
+        if (Event.WorldTime < MinWorldTime) break;
+        if (Event.Action != Action || Event.TriggerEvent != TriggerEvent) continue;
+        if (Event.bConsumed && !bIncludeConsumed) continue;
+        return Index;
+    }
+    return INDEX_NONE;
+}
+
+FCapabilityInputEvent* FCapabilityInputBuffer::FindLatest(const UInputAction* Action, ETriggerEvent TriggerEvent,
+                                                          double MinWorldTime, bool bIncludeConsumed) {
+    const int32 Index = FindLatestIndex(Action, TriggerEvent, MinWorldTime, bIncludeConsumed);
+    return Index != INDEX_NONE ? &Events[Index] : nullptr;
+}
+
+const FCapabilityInputEvent* FCapabilityInputBuffer::FindLatest(const UInputAction* Action, ETriggerEvent TriggerEvent,
+                                                                double MinWorldTime, bool bIncludeConsumed) const {
+    const int32 Index = FindLatestIndex(Action, TriggerEvent, MinWorldTime, bIncludeConsumed);
+    return Index != INDEX_NONE ? &Events[Index] : nullptr;
+}
+
+void FCapabilityInputBuffer::Reset() {
+    Head = 0;
+    Count = 0;
+}
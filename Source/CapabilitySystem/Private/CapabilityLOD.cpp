@@ -0,0 +1,107 @@
+﻿#include "CapabilitySystem/Public/CapabilityLOD.h"
+#include "CapabilitySystem/Public/CapabilityComponent.h"
+#include "CapabilitySystem/Public/CapabilitySystemSetting.h"
+#include "GameFramework/PlayerController.h"
+
+bool UCapabilityLODSubsystem::ShouldCreateSubsystem(UObject* Outer) const {
+    if (!Super::ShouldCreateSubsystem(Outer)) return false;
+    const UCapabilitySystemSetting* Settings = GetDefault<UCapabilitySystemSetting>();
+    return Settings && Settings->bEnableTickLOD && !Settings->LODTiers.IsEmpty();
+}
+
+void UCapabilityLODSubsystem::Initialize(FSubsystemCollectionBase& Collection) {
+    Super::Initialize(Collection);
+    const UCapabilitySystemSetting* Settings = GetDefault<UCapabilitySystemSetting>();
+    Tiers = Settings->LODTiers;
+    UpdateInterval = Settings->LODUpdateInterval;
+    Hysteresis = Settings->LODHysteresis;
+    SignificanceFunction = &UCapabilityLODSubsystem::DefaultSignificance;
+}
+
+void UCapabilityLODSubsystem::RegisterComponent(UCapabilityComponent* Component) {
+    if (!IsValid(Component)) return;
+    Components.AddUnique(Component);
+}
+
+void UCapabilityLODSubsystem::UnregisterComponent(UCapabilityComponent* Component) {
+    Components.RemoveSwap(Component);
+}
+
+void UCapabilityLODSubsystem::SetSignificanceFunction(FCapabilitySignificanceFunction InFunction) {
+    if (InFunction) SignificanceFunction = MoveTemp(InFunction);
+    else SignificanceFunction = &UCapabilityLODSubsystem::DefaultSignificance;
+    TimeSinceUpdate = UpdateInterval;
+}
+
+const FCapabilityLODTier* UCapabilityLODSubsystem::GetTierInfo(int32 Tier) const {
+    return Tiers.IsValidIndex(Tier - 1) ? &Tiers[Tier - 1] : nullptr;
+}
+
+float UCapabilityLODSubsystem::DefaultSignificance(const UCapabilityComponent& Component,
+                                                   const FCapabilityLODViewInfo& ViewInfo) {
+    const AActor* Owner = Component.GetOwner();
+    if (!Owner || ViewInfo.ViewLocations.IsEmpty()) return 0.0f;
+
+    const FVector Location = Owner->GetActorLocation();
+    double MinDistSquared = TNumericLimits<double>::Max();
+    for (const auto& ViewLocation : ViewInfo.ViewLocations) {
+        MinDistSquared = FMath::Min(MinDistSquared, FVector::DistSquared(Location, ViewLocation));
+    }
+
+    float Significance = FMath::Sqrt(MinDistSquared);
+    if (!ViewInfo.bIsDedicatedServer && !Owner->WasRecentlyRendered(0.5f)) {
+        Significance *= GetDefault<UCapabilitySystemSetting>()->NotRenderedSignificanceScale;
+    }
+    return Significance;
+}
+
+void UCapabilityLODSubsystem::GatherViewInfo(FCapabilityLODViewInfo& OutViewInfo) const {
+    const UWorld* World = GetWorld();
+    OutViewInfo.bIsDedicatedServer = World->GetNetMode() == NM_DedicatedServer;
+    for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It) {
+        const APlayerController* PC = It->Get();
+        if (!PC) continue;
+        FVector Location;
+        FRotator Rotation;
+        PC->GetPlayerViewPoint(Location, Rotation);
+        OutViewInfo.ViewLocations.Add(Location);
+    }
+}
+
+int32 UCapabilityLODSubsystem::ComputeTier(float Significance, int32 CurrentTier) const {
+    int32 Target = 0;
+    for (int i = 0; i < Tiers.Num(); i++) {
+        if (Significance >= Tiers[i].Significance) Target = i + 1;
+    }
+
+    if (Target > CurrentTier) {
+        while (Target > CurrentTier && Significance < Tiers[Target - 1].Significance * (1.0f + Hysteresis)) Target--;
+    } else if (Target < CurrentTier) {
+        Target = CurrentTier;
+        while (Target > 0 && Significance < Tiers[Target - 1].Significance * (1.0f - Hysteresis)) Target--;
+    }
+    return Target;
+}
+
+void UCapabilityLODSubsystem::Tick(float DeltaTime) {
+    Super::Tick(DeltaTime);
+
+    TimeSinceUpdate += DeltaTime;
+    if (TimeSinceUpdate < UpdateInterval) return;
+    TimeSinceUpdate = 0.0f;
+
+    SCOPE_CYCLE_COUNTER(STAT_Capability_LODUpdate);
+
+    FCapabilityLODViewInfo ViewInfo;
+    GatherViewInfo(ViewInfo);
+
+    for (int i = Components.Num() - 1; i >= 0; --i) {
+        UCapabilityComponent* Comp = Components[i].Get();
+        if (!Comp) {
+            Components.RemoveAtSwap(i);
+            continue;
+        }
+        const int32 Tier = ComputeTier(SignificanceFunction(*Comp, ViewInfo), Comp->GetLODTier());
+        if (Tier != Comp->GetLODTier()) Comp->SetLODTier(Tier, GetTierInfo(Tier));
+    }
+}
@@ -0,0 +1,149 @@
+﻿#include "CapabilitySystem/Public/CapabilityLite.h"
+#include "CapabilitySystem/Public/CapabilityComponent.h"
+
+void FCapabilityLite::Activate(const FCapabilityLiteContext& Context) {
+    if (bIsCapabilityActive) return;
+    bIsCapabilityActive = true;
+    OnActivated(Context);
+}
+
+void FCapabilityLite::Deactivate(const FCapabilityLiteContext& Context) {
+    if (!bIsCapabilityActive) return;
+    bIsCapabilityActive = false;
+    OnDeactivated(Context);
+}
+
+void FCapabilityLite::UpdateCapabilityState(const FCapabilityLiteContext& Context) {
+    if (bIsCapabilityActive) {
+        if (ShouldDeactivate(Context)) Deactivate(Context);
+    }
+    else {
+        if (ShouldActive(Context)) Activate(Context);
+    }
+}
+
+void FCapabilityLite::NativeBeginPlay(const FCapabilityLiteContext& Context) {
+    if (bHasBegunPlay) return;
+    if (!Context.Component || !Context.Component->HasBegunPlay()) return;
+    bHasBegunPlay = true;
+    INC_DWORD_STAT(STAT_LiteCapabilityCount);
+
+    StartLife(Context);
+
+    bShouldRunOnThisSide = UCapabilityBase::ShouldRunOnSide(Context.Owner, ExecuteSide);
+    if (!bShouldRunOnThisSide) return;
+
+    Setup(Context);
+
+    if (!ShouldDeactivate(Context))
+        Activate(Context);
+    else
+        Deactivate(Context);
+}
+
+void FCapabilityLite::NativePreEndPlay(const FCapabilityLiteContext& Context) {
+    if (!bHasBegunPlay || bHasPreEndedPlay) return;
+    bHasPreEndedPlay = true;
+    Deactivate(Context);
+}
+
+void FCapabilityLite::NativeEndPlay(const FCapabilityLiteContext& Context) {
+    if (!bHasBegunPlay || bHasEndedPlay) return;
+    bHasEndedPlay = true;
+    if (bShouldRunOnThisSide) EndCapability(Context);
+    EndLife(Context);
+    DEC_DWORD_STAT(STAT_LiteCapabilityCount);
+}
+
+void FCapabilityLite::NativeTick(const FCapabilityLiteContext& Context, float DeltaTime) {
+    if (TickInterval <= 0.0f) {
+        UpdateCapabilityState(Context);
+        if (bIsCapabilityActive) Tick(Context, DeltaTime);
+        return;
+    }
+
+    TickTimeSum += DeltaTime;
+    if (TickTimeSum >= TickInterval) {
+        // Whole elapsed time, like UCapabilityBase::NativeTick.
+        const float Elapsed = TickTimeSum;
+        TickTimeSum = 0.0f;
+        UpdateCapabilityState(Context);
+        if (bIsCapabilityActive) Tick(Context, Elapsed);
+    }
+}
+
+void FCapabilityLite::BlockCapability(const FCapabilityLiteContext& Context, const FName& Tag, UObject* From, float Duration) {
+    if (Context.Component) Context.Component->BlockCapability(Tag, From, Duration);
+    else if (Context.BlockState) Context.BlockState->Block(Tag, From, Duration);
+}
+
+void FCapabilityLite::UnBlockCapability(const FCapabilityLiteContext& Context, const FName& Tag, UObject* From) {
+    if (Context.Component) Context.Component->UnBlockCapability(Tag, From);
+    else if (Context.BlockState) Context.BlockState->UnBlock(Tag, From);
+}
+
+void FCapabilityLiteBlockState::Block(const FName& Tag, UObject* Source, float Duration) {
+    const float Remaining = FMath::Max(Duration, 0.0f);
+    for (int i = 0; i < Tags.Num(); i++) {
+        if (Tags[i] == Tag && From[i] == Source) {
+            RemainingTime[i] = Remaining;
+            return;
+        }
+    }
+    Tags.Add(Tag);
+    From.Add(Source);
+    RemainingTime.Add(Remaining);
+    bDirty = true;
+}
+
+void FCapabilityLiteBlockState::UnBlock(const FName& Tag, UObject* Source) {
+    const TWeakObjectPtr<UObject> SourcePtr(Source);
+    for (int i = Tags.Num() - 1; i >= 0; --i) {
+        // Only the caller's entry, plus entries whose source object was destroyed. Null sources stay distinct.
+        const bool bCallerEntry = Tags[i] == Tag && From[i].HasSameIndexAndSerialNumber(SourcePtr);
+        if (bCallerEntry || From[i].IsStale()) {
+            Tags.RemoveAtSwap(i);
+            From.RemoveAtSwap(i);
+            RemainingTime.RemoveAtSwap(i);
+            bDirty = true;
+        }
+    }
+}
+
+void FCapabilityLiteBlockState::AdvanceTimedBlocks(float DeltaTime) {
+    for (int i = RemainingTime.Num() - 1; i >= 0; --i) {
+        if (RemainingTime[i] <= 0.0f) continue;
+        RemainingTime[i] -= DeltaTime;
+        if (RemainingTime[i] > 0.0f) continue;
+        Tags.RemoveAtSwap(i);
+        From.RemoveAtSwap(i);
+        RemainingTime.RemoveAtSwap(i);
+        bDirty = true;
+    }
+}
+
+bool FCapabilityLiteBlockState::IsBlocked(const TArray<FName>& CapabilityTags) const {
+    if (Tags.IsEmpty()) return false;
+    for (const auto& Tag : CapabilityTags) {
+        if (Tags.Contains(Tag)) return true;
+    }
+    return false;
+}
+
+void FCapabilityLiteSet::CallBeginPlay(const FCapabilityLiteContext& Context) {
+    for (int i = 0; i < Capabilities.Num(); i++) {
+        if (auto Lite = Capabilities[i].GetPtr<FCapabilityLite>()) Lite->NativeBeginPlay(Context);
+    }
+}
+
+void FCapabilityLiteSet::CallPreEndPlay(const FCapabilityLiteContext& Context) {
+    for (int i = Capabilities.Num() - 1; i >= 0; --i) {
+        if (auto Lite = Capabilities[i].GetPtr<FCapabilityLite>()) Lite->NativePreEndPlay(Context);
+    }
+}
+
+void FCapabilityLiteSet::CallEndPlay(const FCapabilityLiteContext& Context) {
+    for (int i = Capabilities.Num() - 1; i >= 0; --i) {
+        if (auto Lite = Capabilities[i].GetPtr<FCapabilityLite>()) Lite->NativeEndPlay(Context);
+    }
+}
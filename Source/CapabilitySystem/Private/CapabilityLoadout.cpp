@@ -0,0 +1,68 @@
+﻿#include "CapabilitySystem/Public/CapabilityLoadout.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace CapabilityLoadout {
+    constexpr uint32 Magic = 0x43534C44; // "CSLD"
+    constexpr int32 Version = 2;
+}
+
+void FCapabilityLoadout::Write(TArray<uint8>& OutData) {
+    OutData.Reset();
+    FMemoryWriter Writer(OutData, true);
+    uint32 Magic = CapabilityLoadout::Magic;
+    int32 Version = CapabilityLoadout::Version;
+    Writer << Magic;
+    Writer << Version;
+    Serialize(Writer, Version);
+}
+
+bool FCapabilityLoadout::Read(const TArray<uint8>& Data) {
+    Reset();
+    FMemoryReader Reader(Data, true);
+    uint32 Magic = 0;
+    int32 Version = 0;
+    Reader << Magic;
+    Reader << Version;
+    if (Reader.IsError() || Magic != CapabilityLoadout::Magic || Version < 1 || Version > CapabilityLoadout::Version) return false;
+
+    Serialize(Reader, Version);
+    if (Reader.IsError()) {
+        Reset();
+        return false;
+    }
+    return true;
+}
+
+void FCapabilityLoadout::Reset() {
+    Sets.Reset();
+    BlockedTags.Reset();
+    BlockedTagDurations.Reset();
+}
+
+void FCapabilityLoadout::Serialize(FArchive& Ar, int32 Version) {
+    int32 SetNum = Sets.Num();
+    Ar << SetNum;
+    if (Ar.IsLoading()) {
+        if (SetNum < 0) {
+            Ar.SetError();
+            return;
+        }
+        Sets.SetNum(SetNum);
+    }
+
+    for (auto& Entry : Sets) {
+        FString Path = Ar.IsLoading() ? FString() : Entry.Set.ToString();
+        Ar << Path;
+        if (Ar.IsLoading()) Entry.Set = FSoftObjectPath(Path);
+        Ar << Entry.CapabilityStates;
+        if (Ar.IsError()) return;
+    }
+
+    Ar << BlockedTags;
+
+    // Version 1 loadouts only had permanent blocks.
+    if (Version >= 2) Ar << BlockedTagDurations;
+    else BlockedTagDurations.SetNumZeroed(BlockedTags.Num());
+    if (BlockedTagDurations.Num() != BlockedTags.Num()) Ar.SetError();
+}
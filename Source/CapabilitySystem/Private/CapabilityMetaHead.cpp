@@ -7,16 +7,30 @@ void UCapabilityMetaHead::CallEndPlay() {
     if (bHasEndPlayCalled) return;
     bHasEndPlayCalled = true;
 
-    for (int i = CapabilityList.Num() - 1; i >= 0; i--) {
-        if (CapabilityList[i].IsValid()) CapabilityList[i]->NativePreEndPlay();
+    TArray<UCapabilityBase*> Capabilities;
+    Capabilities.Reserve(CapabilityList.Num() + LocalCapabilities.Num());
+    for (const auto& Capability : CapabilityList) {
+        if (Capability.IsValid()) Capabilities.Add(Capability.Get());
     }
-
-    for (int i = CapabilityList.Num() - 1; i >= 0; i--) {
-        if (CapabilityList[i].IsValid()) CapabilityList[i]->NativeEndPlay();
+    for (const auto& Capability : LocalCapabilities) {
+        if (IsValid(Capability)) Capabilities.Add(Capability);
     }
+    // Set order, so locally spawned capabilities end where they would have among the replicated ones.
+    Capabilities.StableSort([](const UCapabilityBase& A, const UCapabilityBase& B) {
+        return A.GetSetOrder() < B.GetSetOrder();
+    });
+
+    for (int i = Capabilities.Num() - 1; i >= 0; i--) Capabilities[i]->NativePreEndPlay();
+
+    for (int i = Capabilities.Num() - 1; i >= 0; i--) Capabilities[i]->NativeEndPlay();
+
+    for (int i = Capabilities.Num() - 1; i >= 0; i--) Capabilities[i]->MarkAsGarbage();
+
+    LocalCapabilities.Reset();
 
-    for (int i = CapabilityList.Num() - 1; i >= 0; i--) {
-        if (CapabilityList[i].IsValid()) CapabilityList[i]->MarkAsGarbage();
+    // Drop the ended capabilities from the component tick list.
+    if (const auto Comp = Cast<UCapabilityComponent>(GetOuter())) {
+        Comp->NotifyShouldUpdateTickStatusNextFrame();
     }
 }
 
@@ -33,4 +47,6 @@ void UCapabilityMetaHead::PreDestroyFromReplication() {
 void UCapabilityMetaHead::GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const {
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
     DOREPLIFETIME_CONDITION_NOTIFY(ThisClass, CapabilityList, COND_InitialOnly, REPNOTIFY_OnChanged);
+    DOREPLIFETIME_CONDITION(ThisClass, ClientOnlyClasses, COND_InitialOnly);
+    DOREPLIFETIME_CONDITION(ThisClass, ClientOnlyIndices, COND_InitialOnly);
 }
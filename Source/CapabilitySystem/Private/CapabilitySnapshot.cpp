@@ -0,0 +1,67 @@
+﻿#include "CapabilitySystem/Public/CapabilitySnapshot.h"
+
+FCapabilityStateRing::~FCapabilityStateRing() {
+    DEC_MEMORY_STAT_BY(STAT_CapabilitySnapshotMemory, TrackedMemory);
+}
+
+FCapabilityStateFrame& FCapabilityStateRing::Write(int32 Frame, int32 Capacity) {
+    check(Capacity > 0);
+    if (Frames.Num() != Capacity) {
+        Frames.SetNum(Capacity);
+        Head = 0;
+        Count = 0;
+    }
+
+    DiscardAfter(Frame - 1);
+
+    FCapabilityStateFrame& Slot = Frames[Head];
+    Slot.Frame = Frame;
+    Slot.Topology = 0;
+    Slot.Data.Reset();
+    Head = (Head + 1) % Capacity;
+    Count = FMath::Min(Count + 1, Capacity);
+    return Slot;
+}
+
+const FCapabilityStateFrame* FCapabilityStateRing::Find(int32 Frame) const {
+    const int32 Capacity = Frames.Num();
+    for (int32 i = 0; i < Count; i++) {
+        const FCapabilityStateFrame& Slot = Frames[(Head - 1 - i + Capacity) % Capacity];
+        if (Slot.Frame == Frame) return &Slot;
+        if (Slot.Frame < Frame) break;
+    }
+    return nullptr;
+}
+
+void FCapabilityStateRing::DiscardAfter(int32 Frame) {
+    const int32 Capacity = Frames.Num();
+    while (Count > 0) {
+        const int32 Newest = (Head - 1 + Capacity) % Capacity;
+        if (Frames[Newest].Frame <= Frame) break;
+        Frames[Newest].Frame = INDEX_NONE;
+        Head = Newest;
+        Count--;
+    }
+}
+
+void FCapabilityStateRing::Reset() {
+    for (auto& Slot : Frames) Slot.Frame = INDEX_NONE;
+    Head = 0;
+    Count = 0;
+}
+
+SIZE_T FCapabilityStateRing::GetAllocatedSize() const {
+    SIZE_T Size = Frames.GetAllocatedSize();
+    for (const auto& Slot : Frames) Size += Slot.Data.GetAllocatedSize();
+    return Size;
+}
+
+void FCapabilityStateRing::UpdateMemoryStat() {
+#if STATS
+    const SIZE_T Size = GetAllocatedSize();
+    if (Size == TrackedMemory) return;
+    DEC_MEMORY_STAT_BY(STAT_CapabilitySnapshotMemory, TrackedMemory);
+    INC_MEMORY_STAT_BY(STAT_CapabilitySnapshotMemory, Size);
+    TrackedMemory = Size;
+#endif
+}
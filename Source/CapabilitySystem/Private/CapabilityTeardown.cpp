@@ -0,0 +1,60 @@
+﻿#include "CapabilitySystem/Public/CapabilityTeardown.h"
+#include "CapabilitySystem/Public/CapabilitySystemSetting.h"
+#include "Components/ActorComponent.h"
+
+bool UCapabilityTeardownSubsystem::ShouldCreateSubsystem(UObject* Outer) const {
+    if (!Super::ShouldCreateSubsystem(Outer)) return false;
+    const UCapabilitySystemSetting* Settings = GetDefault<UCapabilitySystemSetting>();
+    return Settings && Settings->bDeferredTeardown;
+}
+
+void UCapabilityTeardownSubsystem::Initialize(FSubsystemCollectionBase& Collection) {
+    Super::Initialize(Collection);
+    BudgetSeconds = GetDefault<UCapabilitySystemSetting>()->TeardownBudgetMs / 1000.0;
+}
+
+void UCapabilityTeardownSubsystem::Deinitialize() {
+    // The world is going away, release what is left at once.
+    for (int32 i = Head; i < Pending.Num(); ++i) Release(Pending[i].Get());
+    DEC_DWORD_STAT_BY(STAT_PendingCapabilityTeardown, Pending.Num() - Head);
+    Pending.Empty();
+    Head = 0;
+    Super::Deinitialize();
+}
+
+void UCapabilityTeardownSubsystem::Enqueue(TConstArrayView<UObject*> Objects) {
+    Pending.Reserve(Pending.Num() + Objects.Num());
+    for (UObject* Object : Objects) Pending.Emplace(Object);
+    INC_DWORD_STAT_BY(STAT_PendingCapabilityTeardown, Objects.Num());
+}
+
+void UCapabilityTeardownSubsystem::Tick(float DeltaTime) {
+    SCOPE_CYCLE_COUNTER(STAT_Capability_Teardown);
+
+    const double EndTime = FPlatformTime::Seconds() + BudgetSeconds;
+    const int32 Start = Head;
+
+    // At least one object per frame, so the queue always drains.
+    do {
+        Release(Pending[Head++].Get());
+    } while (Head < Pending.Num() && FPlatformTime::Seconds() < EndTime);
+    DEC_DWORD_STAT_BY(STAT_PendingCapabilityTeardown, Head - Start);
+
+    if (Head == Pending.Num()) {
+        Pending.Reset();
+        Head = 0;
+    } else if (Head > Pending.Num() / 2) {
+        // Each entry is moved at most once per halving, amortized O(1) per released object.
+        Pending.RemoveAt(0, Head);
+        Head = 0;
+    }
+}
+
+void UCapabilityTeardownSubsystem::Release(UObject* Object) {
+    if (!IsValid(Object)) return;
+    if (const auto Comp = Cast<UActorComponent>(Object)) {
+        Comp->DestroyComponent();
+    } else {
+        Object->MarkAsGarbage();
+    }
+}
@@ -0,0 +1,61 @@
+﻿#include "CapabilitySystem/Public/CapabilityTickBudget.h"
+#include "CapabilitySystem/Public/CapabilitySystemSetting.h"
+
+bool UCapabilityTickBudgetSubsystem::ShouldCreateSubsystem(UObject* Outer) const {
+    if (!Super::ShouldCreateSubsystem(Outer)) return false;
+    const UCapabilitySystemSetting* Settings = GetDefault<UCapabilitySystemSetting>();
+    return Settings && Settings->TickBudgetMs > 0.0f;
+}
+
+void UCapabilityTickBudgetSubsystem::Initialize(FSubsystemCollectionBase& Collection) {
+    Super::Initialize(Collection);
+    const UCapabilitySystemSetting* Settings = GetDefault<UCapabilitySystemSetting>();
+    BudgetSeconds = Settings->TickBudgetMs / 1000.0;
+    NormalStride = FMath::Max(1, Settings->NormalPriorityDeferStride);
+    LowStride = FMath::Max(1, Settings->LowPriorityDeferStride);
+    CurrentFrame = GFrameCounter;
+}
+
+void UCapabilityTickBudgetSubsystem::RollFrame() {
+    if (CurrentFrame == GFrameCounter) return;
+    CurrentFrame = GFrameCounter;
+    LastFrameSeconds = FrameSeconds;
+    LastFrameDeferredCount = FrameDeferredCount;
+    FrameSeconds = 0.0;
+    FrameDeferredCount = 0;
+    FrameMaxLatency = 0.0f;
+}
+
+bool UCapabilityTickBudgetSubsystem::IsOverBudget() {
+    RollFrame();
+    return FrameSeconds > BudgetSeconds || LastFrameSeconds > BudgetSeconds;
+}
+
+bool UCapabilityTickBudgetSubsystem::ShouldDefer(ECapabilityTickPriority Priority, uint32 Slot) const {
+    switch (Priority) {
+    case ECapabilityTickPriority::Normal:
+        return (CurrentFrame + Slot) % NormalStride != 0;
+    case ECapabilityTickPriority::Low:
+        return (CurrentFrame + Slot) % LowStride != 0;
+    default:
+        return false;
+    }
+}
+
+void UCapabilityTickBudgetSubsystem::ConsumeBudget(uint64 Cycles) {
+    RollFrame();
+    FrameSeconds += FPlatformTime::ToSeconds64(Cycles);
+}
+
+void UCapabilityTickBudgetSubsystem::NotifyDeferred() {
+    FrameDeferredCount++;
+    INC_DWORD_STAT(STAT_DeferredCapabilityCount);
+}
+
+void UCapabilityTickBudgetSubsystem::NotifyResumed(float DeferredTime) {
+    if (DeferredTime > FrameMaxLatency) {
+        FrameMaxLatency = DeferredTime;
+        SET_FLOAT_STAT(STAT_CapabilityMaxDeferralLatency, DeferredTime * 1000.0f);
+    }
+    MaxDeferralLatency = FMath::Max(MaxDeferralLatency, DeferredTime);
+}
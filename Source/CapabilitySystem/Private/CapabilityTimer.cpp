@@ -0,0 +1,129 @@
+﻿#include "CapabilitySystem/Public/CapabilityTimer.h"
+#include "CapabilitySystem/Public/CapabilityBase.h"
+#include "CapabilitySystem/Public/CapabilityComponent.h"
+#include "CapabilitySystem/Public/CapabilitySystemSetting.h"
+
+void UCapabilityTimerSubsystem::Initialize(FSubsystemCollectionBase& Collection) {
+    Super::Initialize(Collection);
+    const auto Setting = GetDefault<UCapabilitySystemSetting>();
+    if (Setting && Setting->TimerResolution > 0.0f) Resolution = Setting->TimerResolution;
+}
+
+void UCapabilityTimerSubsystem::Deinitialize() {
+    DEC_DWORD_STAT_BY(STAT_PendingTimedBlocks, BlockExpiries.Num());
+    BlockExpiries.Reset();
+    DEC_DWORD_STAT_BY(STAT_ActiveCapabilityTimers, Timers.Num());
+    TimerWheel.Reset();
+    Timers.Reset();
+    Super::Deinitialize();
+}
+
+void UCapabilityTimerSubsystem::Tick(float DeltaTime) {
+    SCOPE_CYCLE_COUNTER(STAT_Capability_Timers);
+
+    PendingTime += DeltaTime;
+    const uint64 Ticks = static_cast<uint64>(PendingTime / Resolution);
+    if (Ticks == 0) return;
+    PendingTime -= Ticks * Resolution;
+
+    BlockExpiries.Advance(Ticks, [](FCapabilityBlockExpiry&& Expiry) {
+        DEC_DWORD_STAT(STAT_PendingTimedBlocks);
+        if (const auto Component = Expiry.Component.Get()) {
+            Component->OnTimedBlockExpired(Expiry.Tag, Expiry.From);
+        }
+    });
+
+    TimerWheel.Advance(Ticks, [this](uint64&& Id) { FireTimer(Id); });
+}
+
+void UCapabilityTimerSubsystem::FireTimer(uint64 Id) {
+    FCapabilityTimer* Timer = Timers.Find(Id);
+    if (!Timer) return;
+
+    UCapabilityBase* Capability = Timer->Capability.Get();
+    if (!Capability) {
+        Timers.Remove(Id);
+        DEC_DWORD_STAT(STAT_ActiveCapabilityTimers);
+        return;
+    }
+
+    INC_DWORD_STAT(STAT_FiredCapabilityTimers);
+    const bool bWakeUp = Timer->bWakeUp;
+    FCapabilityTimerDelegate Delegate;
+    TFunction<void()> Callback;
+
+    // Reschedule or retire before calling out, the callback may clear or set timers and rehash the map.
+    if (Timer->LoopTicks > 0) {
+        Timer->WheelHandle = TimerWheel.Schedule(Timer->LoopTicks, uint64(Id));
+        Delegate = Timer->Delegate;
+        Callback = Timer->Callback;
+    } else {
+        Delegate = MoveTemp(Timer->Delegate);
+        Callback = MoveTemp(Timer->Callback);
+        Timers.Remove(Id);
+        DEC_DWORD_STAT(STAT_ActiveCapabilityTimers);
+        Capability->ForgetTimer(FCapabilityTimerHandle(Id));
+    }
+
+    if (bWakeUp) {
+        Capability->WakeUp();
+    } else if (Callback) {
+        Callback();
+    } else {
+        Delegate.ExecuteIfBound();
+    }
+}
+
+FCapabilityTimerHandle UCapabilityTimerSubsystem::SetTimer(UCapabilityBase* Capability, FCapabilityTimer&& Timer,
+                                                          float Delay, float Interval) {
+    if (!Capability) return FCapabilityTimerHandle();
+
+    const uint64 Id = NextTimerId++;
+    Timer.Capability = Capability;
+    Timer.LoopTicks = Interval > 0.0f ? FMath::Max<uint64>(1, static_cast<uint64>(FMath::RoundToDouble(Interval / Resolution))) : 0;
+    Timer.WheelHandle = TimerWheel.Schedule(SecondsToTicks(Delay), uint64(Id));
+    Timers.Add(Id, MoveTemp(Timer));
+    INC_DWORD_STAT(STAT_ActiveCapabilityTimers);
+    return FCapabilityTimerHandle(Id);
+}
+
+void UCapabilityTimerSubsystem::ClearTimer(FCapabilityTimerHandle& Handle) {
+    FCapabilityTimer Timer;
+    if (Timers.RemoveAndCopyValue(Handle.Id, Timer)) {
+        TimerWheel.Cancel(Timer.WheelHandle);
+        DEC_DWORD_STAT(STAT_ActiveCapabilityTimers);
+    }
+    Handle.Invalidate();
+}
+
+float UCapabilityTimerSubsystem::GetTimerRemainingTime(const FCapabilityTimerHandle& Handle) const {
+    const auto Timer = Timers.Find(Handle.Id);
+    if (!Timer || !TimerWheel.IsPending(Timer->WheelHandle)) return 0.0f;
+    return GetRemainingTime(TimerWheel.GetRemainingTicks(Timer->WheelHandle));
+}
+
+FCapabilityTimingWheelHandle UCapabilityTimerSubsystem::ScheduleBlockExpiry(UCapabilityComponent* Component,
+                                                                            const FName& Tag, UObject* From,
+                                                                            float Duration) {
+    INC_DWORD_STAT(STAT_PendingTimedBlocks);
+    return BlockExpiries.Schedule(SecondsToTicks(Duration), FCapabilityBlockExpiry{Component, Tag, From});
+}
+
+void UCapabilityTimerSubsystem::CancelBlockExpiry(FCapabilityTimingWheelHandle& Handle) {
+    if (BlockExpiries.Cancel(Handle)) DEC_DWORD_STAT(STAT_PendingTimedBlocks);
+    Handle.Invalidate();
+}
+
+float UCapabilityTimerSubsystem::GetBlockRemainingTime(const FCapabilityTimingWheelHandle& Handle) const {
+    if (!BlockExpiries.IsPending(Handle)) return 0.0f;
+    return GetRemainingTime(BlockExpiries.GetRemainingTicks(Handle));
+}
+
+float UCapabilityTimerSubsystem::GetRemainingTime(uint64 Ticks) const {
+    return FMath::Max(0.0, Ticks * Resolution - PendingTime);
+}
+
+uint64 UCapabilityTimerSubsystem::SecondsToTicks(float Seconds) const {
+    // Round up and count the partial tick already elapsed, a timer never fires early.
+    return static_cast<uint64>(FMath::CeilToDouble((Seconds + PendingTime) / Resolution));
+}
@@ -1,6 +1,18 @@
 ﻿#include "CapabilitySystem/Public/InputAssetManager.h"
 #include "CapabilitySystem/Public/CapabilityCommon.h"
 #include "EnhancedInput/Public/InputMappingContext.h"
+#include "Engine/AssetManager.h"
+#include "Engine/GameInstance.h"
+
+bool UInputAssetManager::ShouldCreateSubsystem(UObject* Outer) const {
+    if (!Super::ShouldCreateSubsystem(Outer)) return false;
+
+    const UInputAssetManagerSetting* Settings = GetDefault<UInputAssetManagerSetting>();
+    if (!Settings || !Settings->bSkipOnDedicatedServer) return true;
+
+    const UGameInstance* GameInstance = Cast<UGameInstance>(Outer);
+    return !IsRunningDedicatedServer() && !(GameInstance && GameInstance->IsDedicatedServerInstance());
+}
 
 void UInputAssetManager::Initialize(FSubsystemCollectionBase& Collection) {
     Super::Initialize(Collection);
@@ -9,43 +21,111 @@ void UInputAssetManager::Initialize(FSubsystemCollectionBase& Collection) {
 }
 
 void UInputAssetManager::Deinitialize() {
+    if (PreloadHandle.IsValid()) {
+        PreloadHandle->CancelHandle();
+        PreloadHandle.Reset();
+    }
+    OnInputAssetsReady.Clear();
     InputActionMap.Empty();
     InputMappingContextMap.Empty();
+    InputActionPaths.Empty();
+    InputMappingContextPaths.Empty();
+    bIsReady = false;
     Instance = nullptr;
     Super::Deinitialize();
 }
 
+void UInputAssetManager::BuildAssetIndex() {
+    const UInputAssetManagerSetting* Settings = GetDefault<UInputAssetManagerSetting>();
+    if (!Settings) return;
+
+    for (const auto& IA : Settings->InputActions) {
+        if (!IA.IsNull()) InputActionPaths.Add(FName(IA.GetAssetName()), IA.ToSoftObjectPath());
+    }
+    for (const auto& IMC : Settings->InputMappingContexts) {
+        if (!IMC.IsNull()) InputMappingContextPaths.Add(FName(IMC.GetAssetName()), IMC.ToSoftObjectPath());
+    }
+}
+
 void UInputAssetManager::ScanAndLoadInputAssets() {
     const UInputAssetManagerSetting* Settings = GetDefault<UInputAssetManagerSetting>();
     if (!Settings) return;
-    
-    for (auto IA : Settings->InputActions) {
-        if (auto P = IA.LoadSynchronous()) {
-            InputActionMap.Add(P->GetFName(), P);
+
+    BuildAssetIndex();
+
+    switch (Settings->LoadMode) {
+    case EInputAssetLoadMode::Synchronous:
+        OnPreloadComplete();
+        break;
+
+    case EInputAssetLoadMode::AsyncPreload: {
+        TArray<FSoftObjectPath> Paths;
+        InputActionPaths.GenerateValueArray(Paths);
+        for (const auto& Pair : InputMappingContextPaths) Paths.Add(Pair.Value);
+        if (Paths.IsEmpty()) {
+            OnPreloadComplete();
+            break;
         }
+        PreloadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+            MoveTemp(Paths), FStreamableDelegate::CreateUObject(this, &UInputAssetManager::OnPreloadComplete));
+        UE_LOG(CapabilitySystemLog, Log, TEXT("UInputAssetManager: Async preload started, Action %d, IMC %d."),
+               InputActionPaths.Num(), InputMappingContextPaths.Num());
+        break;
+    }
+
+    case EInputAssetLoadMode::OnDemand:
+        bIsReady = true;
+        UE_LOG(CapabilitySystemLog, Log, TEXT("UInputAssetManager: On demand, indexed Action %d, IMC %d."),
+               InputActionPaths.Num(), InputMappingContextPaths.Num());
+        break;
+    }
+}
+
+void UInputAssetManager::OnPreloadComplete() {
+    PreloadHandle.Reset();
+
+    for (const auto& Pair : InputActionPaths) {
+        ResolveAsset(Pair.Key, InputActionMap, InputActionPaths, true);
     }
     UE_LOG(CapabilitySystemLog, Log, TEXT("UInputAssetManager: Load Action Complete, Count %d."), InputActionMap.Num());
-    
-    for (auto IMC : Settings->InputMappingContexts) {
-        if (auto P = IMC.LoadSynchronous()) {
-            InputMappingContextMap.Add(P->GetFName(), P);
-        }
+
+    for (const auto& Pair : InputMappingContextPaths) {
+        ResolveAsset(Pair.Key, InputMappingContextMap, InputMappingContextPaths, true);
     }
-    
     UE_LOG(CapabilitySystemLog, Log, TEXT("UInputAssetManager: Load IMC Complete, Count %d."), InputMappingContextMap.Num());
+
+    bIsReady = true;
+    OnInputAssetsReady.Broadcast();
+}
+
+template <typename T>
+T* UInputAssetManager::ResolveAsset(const FName& Name, TMap<FName, TObjectPtr<T>>& LoadedMap,
+                                    const TMap<FName, FSoftObjectPath>& PathMap, bool bLoadIfMissing) {
+    if (const TObjectPtr<T>* Found = LoadedMap.Find(Name)) return *Found;
+
+    const FSoftObjectPath* Path = PathMap.Find(Name);
+    if (!Path) return nullptr;
+
+    T* Asset = Cast<T>(Path->ResolveObject());
+    if (!Asset && bLoadIfMissing) {
+        UE_LOG(CapabilitySystemLog, Verbose, TEXT("UInputAssetManager: Loading %s on demand."), *Path->ToString());
+        Asset = Cast<T>(Path->TryLoad());
+    }
+    if (Asset) LoadedMap.Add(Name, Asset);
+    return Asset;
 }
 
 UInputAction* UInputAssetManager::FindAction(const FName& ActionName) const {
-    if (const TObjectPtr<UInputAction>* FoundAction = InputActionMap.Find(ActionName)) {
-        return *FoundAction;
+    if (UInputAction* FoundAction = ResolveAsset(ActionName, InputActionMap, InputActionPaths, true)) {
+        return FoundAction;
     }
     UE_LOG(CapabilitySystemLog, Error, TEXT("Could not find Input Action: %s"), *ActionName.ToString());
     return nullptr;
 }
 
 UInputMappingContext* UInputAssetManager::FindIMC(const FName& IMCName) const {
-    if (const TObjectPtr<UInputMappingContext>* FoundIMC = InputMappingContextMap.Find(IMCName)) {
-        return *FoundIMC;
+    if (UInputMappingContext* FoundIMC = ResolveAsset(IMCName, InputMappingContextMap, InputMappingContextPaths, true)) {
+        return FoundIMC;
     }
     UE_LOG(CapabilitySystemLog, Error, TEXT("Could not find Input Mapping Context: %s"), *IMCName.ToString());
     return nullptr;
@@ -53,7 +133,7 @@ UInputMappingContext* UInputAssetManager::FindIMC(const FName& IMCName) const {
 
 FString UInputAssetManager::ToStringAllIMC() const {
     FString Result;
-    for (const auto& Pair : InputMappingContextMap) {
+    for (const auto& Pair : InputMappingContextPaths) {
         Result += Pair.Key.ToString() + "\n";
     }
     return Result;
@@ -61,7 +141,7 @@ FString UInputAssetManager::ToStringAllIMC() const {
 
 FString UInputAssetManager::ToStringAllAction() const {
     FString Result;
-    for (const auto& Pair : InputActionMap) {
+    for (const auto& Pair : InputActionPaths) {
         Result += Pair.Key.ToString() + "\n";
     }
     return Result;
@@ -89,4 +169,8 @@ FString UInputAssetManagerBind::GetStringAllIMC() {
     if (UInputAssetManager::Instance)
         return UInputAssetManager::Instance->ToStringAllIMC();
     return "";
-}
\ No newline at end of file
+}
+
+bool UInputAssetManagerBind::IsInputAssetsReady() {
+    return UInputAssetManager::Instance && UInputAssetManager::Instance->IsReady();
+}
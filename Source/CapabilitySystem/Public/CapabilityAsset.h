@@ -3,9 +3,11 @@
 
 #include "CoreMinimal.h"
 #include "CapabilityBase.h"
+#include "InstancedStruct.h"
 #include "CapabilityAsset.generated.h"
 
 class UCapabilityDataComponent;
+class UCapabilityInput;
 
 UCLASS(Blueprintable, BlueprintType)
 class CAPABILITYSYSTEM_API UCapabilitySet : public UPrimaryDataAsset {
@@ -17,6 +19,39 @@ public:
     
     UPROPERTY(EditAnywhere)
     TArray<TSubclassOf<UCapabilityDataComponent>> ClassOfComponent;
+
+    // Struct based capabilities (FCapabilityLite), created locally on every side, tick after ClassOfCapability.
+    UPROPERTY(EditAnywhere, meta = (BaseStruct = "/Script/CapabilitySystem.CapabilityLite", ExcludeBaseStruct))
+    TArray<FInstancedStruct> LiteCapabilities;
+
+    UPROPERTY(EditAnywhere, meta = (InlineEditConditionToggle))
+    bool bOverrideTickPriority = false;
+
+    // Tick budget priority applied to every capability of this set.
+    UPROPERTY(EditAnywhere, meta = (EditCondition = "bOverrideTickPriority"))
+    ECapabilityTickPriority TickPriority = ECapabilityTickPriority::High;
+
+    void ApplySetConfig(UCapabilityBase* Capability) const;
+
+    /**
+      * Tick layer per ClassOfCapability entry: one past the highest layer of the earlier entries it conflicts with
+      * (one writes a data component the other reads or writes). Entries of a layer are independent of each other.
+      * Capabilities without declared data access conflict with everything. Built on first use from the class configs,
+      * instances declaring other data access tick serially.
+      */
+    const TArray<int32>& GetTickLayers() const;
+
+#if WITH_EDITOR
+    virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+    mutable TArray<int32> TickLayers;
+
+    mutable bool bTickLayersBuilt = false;
+
+    // UCapabilityBase::GetClassConfigGeneration the layers were built against.
+    mutable uint32 TickLayersGeneration = 0;
 };
 
 UCLASS(Blueprintable, BlueprintType)
@@ -80,6 +115,12 @@ struct FCapabilityObjectRefSet {
     UPROPERTY()
     TArray<TSubclassOf<UCapabilityDataComponent>> ClassOfComponents;
 
+    // Input capabilities of ObjectRefs in set order, filled once by CacheInputRefs.
+    UPROPERTY(NotReplicated)
+    TArray<TObjectPtr<UCapabilityInput>> InputRefs;
+
+    void CacheInputRefs();
+
     void CallBeginPlay();
 
     void CallPreEndPlay();
@@ -5,12 +5,23 @@
 #include "UObject/Object.h"
 #include "CapabilityCommon.h"
 #include "CapabilityDataComponent.h"
+#include "CapabilityTimer.h"
+#include "CapabilityTask.h"
+#include "CapabilityEventBus.h"
 #include "CapabilityBase.generated.h"
 
 class UCapabilityMetaHead;
 class UCapabilityComponent;
+struct FCapabilityLODTier;
 
 DECLARE_DWORD_COUNTER_STAT(TEXT("Capability Count"), STAT_CapabilityCount, STATGROUP_Capability);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Capability Class Config Count"), STAT_CapabilityClassConfigCount, STATGROUP_Capability);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Capability Config Override Count"), STAT_CapabilityConfigOverrideCount, STATGROUP_Capability);
+DECLARE_MEMORY_STAT(TEXT("Capability Config Memory"), STAT_CapabilityConfigMemory, STATGROUP_Capability);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Capability Fixed Steps"), STAT_CapabilityFixedSteps, STATGROUP_Capability);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Capability Dropped Fixed Steps"), STAT_CapabilityDroppedFixedSteps, STATGROUP_Capability);
+DECLARE_CYCLE_STAT(TEXT("Capability Parallel Tick"), STAT_Capability_ParallelTick, STATGROUP_Capability);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Parallel Ticked Capabilities"), STAT_ParallelTickedCapabilities, STATGROUP_Capability);
 
 UENUM(BlueprintType)
 enum class ECapabilityExecuteSide : uint8 {
@@ -22,6 +33,63 @@ enum class ECapabilityExecuteSide : uint8 {
     OwnerLocalControlledOnly UMETA(DisplayName = "Owner Local Controlled Only"),
 };
 
+UENUM(BlueprintType)
+enum class ECapabilityTickPriority : uint8 {
+    High UMETA(DisplayName = "High (Never Deferred)"),
+    Normal UMETA(DisplayName = "Normal"),
+    Low UMETA(DisplayName = "Low"),
+};
+
+/**
+ * Array config shared by every instance of a capability class, built once from the class default object.
+ * Capabilities free their own copies of these arrays at begin play and read the shared ones from then on.
+ */
+struct FCapabilityClassConfig {
+    TArray<FName> Tags;
+
+    TArray<float> LODTickIntervals;
+
+    TArray<TSubclassOf<UCapabilityDataComponent>> ReadsData;
+
+    TArray<TSubclassOf<UCapabilityDataComponent>> WritesData;
+
+    // Capabilities resolved to this config, game thread only. A config dropped by reinstancing is freed at zero.
+    mutable int32 RefCount = 0;
+
+    bool bRetired = false;
+
+    SIZE_T GetAllocatedSize() const;
+};
+
+// Arrays of one capability that differ from its class config, only the ones that differ are set.
+struct FCapabilityConfigOverride {
+    TOptional<TArray<FName>> Tags;
+
+    TOptional<TArray<float>> LODTickIntervals;
+
+    TOptional<TArray<TSubclassOf<UCapabilityDataComponent>>> ReadsData;
+
+    TOptional<TArray<TSubclassOf<UCapabilityDataComponent>>> WritesData;
+
+    bool IsEmpty() const { return !Tags && !LODTickIntervals && !ReadsData && !WritesData; }
+
+    SIZE_T GetAllocatedSize() const;
+};
+
+#if !UE_BUILD_SHIPPING
+// Capability whose tick runs on this thread, checked by the data access validator.
+struct CAPABILITYSYSTEM_API FCapabilityDataAccessScope {
+    explicit FCapabilityDataAccessScope(const UCapabilityBase* Capability);
+
+    ~FCapabilityDataAccessScope();
+
+    static const UCapabilityBase* GetCurrent();
+
+private:
+    const UCapabilityBase* Previous;
+};
+#endif
+
 UCLASS(Abstract, NotBlueprintable)
 class CAPABILITYSYSTEM_API UCapabilityBase : public UObject {
     GENERATED_BODY()
@@ -32,6 +100,102 @@ class CAPABILITYSYSTEM_API UCapabilityBase : public UObject {
     bool bHasEndedPlay = false;
     bool bHasPreEndedPlay = false;
 
+    // Read through GetTags / SetTags, the class config holds the values once the capability has begun play.
+    UPROPERTY(EditDefaultsOnly, BlueprintGetter = K2_GetTags, BlueprintSetter = SetTags, meta = (AllowPrivateAccess = "true"))
+    TArray<FName> Tags;
+
+    // Optional per LOD tier tick interval (index = tier, entry 0 is unused as tier 0 always ticks at full rate),
+    // negative entries fall back to the tier scale.
+    UPROPERTY(EditDefaultsOnly, BlueprintGetter = K2_GetLODTickIntervals, meta = (AllowPrivateAccess = "true"))
+    TArray<float> LODTickIntervals;
+
+    /**
+      * Data component classes this capability reads / writes. Within a set a capability only keeps its
+      * ClassOfCapability order against the capabilities it conflicts with (one of them writes data the other uses).
+      * Declaring neither keeps the plain set order.
+      */
+    UPROPERTY(EditDefaultsOnly, meta = (AllowPrivateAccess = "true"))
+    TArray<TSubclassOf<UCapabilityDataComponent>> ReadsData;
+
+    UPROPERTY(EditDefaultsOnly, meta = (AllowPrivateAccess = "true"))
+    TArray<TSubclassOf<UCapabilityDataComponent>> WritesData;
+
+    // Resolved at begin play, null before. The array properties above are emptied once it is set.
+    const FCapabilityClassConfig* Config = nullptr;
+
+    // Null unless an array of this instance differs from its class config.
+    TUniquePtr<FCapabilityConfigOverride> ConfigOverride;
+
+    FCapabilityClassConfig ReadConfigProperties() const;
+
+    void ResolveClassConfig();
+
+    FCapabilityConfigOverride& GetMutableOverride();
+
+    // Frees the override once SetTags brought every array back to the class config.
+    void ReleaseOverrideIfEmpty();
+
+    template <typename T>
+    const TArray<T>& ReadConfigArray(TOptional<TArray<T>> FCapabilityConfigOverride::* OverrideField,
+                                     TArray<T> FCapabilityClassConfig::* ClassField, const TArray<T>& Property) const {
+        if (ConfigOverride && (ConfigOverride.Get()->*OverrideField).IsSet()) {
+            return (ConfigOverride.Get()->*OverrideField).GetValue();
+        }
+        return Config ? Config->*ClassField : Property;
+    }
+
+    // Runs the whole fixed steps contained in the accumulated time, at most maxFixedSubsteps per call.
+    void NativeFixedTick(float DeltaTime);
+
+    // Whole steps beyond the catch-up bound are dropped so a hitch cannot spiral, the fraction is kept.
+    void DropExcessFixedSteps(float Step);
+
+    // Tick, or TickParallel for bParallelTick capabilities, inside the data access validator scope.
+    void RunTick(float DeltaTime);
+
+    /**
+      * Game thread half of a parallel tick: tick interval / fixed step accounting and UpdateCapabilityState.
+      * Returns how many TickParallel calls of OutDelta the worker should run.
+      */
+    int32 PrepareParallelTick(float DeltaTime, float& OutDelta);
+
+    // Activation / tick flags, tick accumulators, then SerializeRollbackState.
+    void NativeSerializeRollbackState(FArchive& Ar);
+
+    // Timers still pending in the world timer subsystem, cleared at end play.
+    TArray<FCapabilityTimerHandle, TInlineAllocator<2>> ActiveTimers;
+
+    UCapabilityTimerSubsystem* GetTimerSubsystem() const;
+
+    FCapabilityTimerHandle StartTimer(FCapabilityTimer&& Timer, float Delay, float Interval);
+
+    void ClearAllCapabilityTimers();
+
+    // A one-shot timer fired, called by UCapabilityTimerSubsystem.
+    void ForgetTimer(const FCapabilityTimerHandle& Handle) { ActiveTimers.RemoveSwap(Handle); }
+
+    friend class UCapabilityTimerSubsystem;
+
+    friend class UCapabilityBatchTickSubsystem;
+
+    // Position in UCapabilityBatchTickSubsystem, INDEX_NONE while not batch ticked.
+    int32 BatchBucket = INDEX_NONE;
+
+    int32 BatchSlot = INDEX_NONE;
+
+    // Latent tasks waiting to resume, cancelled on Deactivate and at end play.
+    TArray<FCapabilityTask> PendingTasks;
+
+    uint64 NextTaskId = 1;
+
+    FCapabilityTaskHandle StartDelayTask(float Seconds, FCapabilityTask&& Task);
+
+    FCapabilityTaskHandle StartTagUnblockedTask(FName Tag, FCapabilityTask&& Task);
+
+    FCapabilityTaskHandle StartDataNotifyTask(UCapabilityDataComponent* Data, FName Key, FCapabilityTask&& Task);
+
+    void CancelAllTasks();
+
 protected:
 
     UPROPERTY(Replicated)
@@ -42,6 +206,11 @@ protected:
 
     UPROPERTY(Replicated)
     int16 IndexInSet = 0;
+
+    // InstanceID of the owning capability set, assigned before begin play on every side.
+    uint32 SetInstanceID = 0;
+
+    bool bHasEventSubscriptions = false;
     
     UPROPERTY(BlueprintReadOnly)
     bool bCanEverTick = true;
@@ -53,18 +222,102 @@ protected:
     
     float tickTimeSum = 0.0f;
 
+    UPROPERTY(BlueprintReadOnly)
+    ECapabilityTickPriority tickPriority = ECapabilityTickPriority::High;
+
+    // Delta accumulated while deferred by the tick budget.
+    float deferredTime = 0.0f;
+
+    // Ignore the component tick LOD, always run at the configured tickInterval.
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+    bool bIgnoreTickLOD = false;
+
+    float lodTickIntervalScale = 1.0f;
+
+    float lodMinTickInterval = 0.0f;
+
+    float lodOverrideTickInterval = -1.0f;
+
+    bool bLODSuspended = false;
+
+    /**
+      * Tick in fixed steps (tickInterval if set, otherwise the component / project fixed timestep) and catch up
+      * missed steps, so Tick always receives the exact step delta on server and clients. LOD interval scaling is ignored.
+      */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+    bool bFixedTimestep = false;
+
+    /**
+      * Tick together with every instance of this class in the world (UCapabilityBatchTickSubsystem) instead of in the
+      * component's set order. Only for capabilities with no ordering dependency on other capabilities of the actor.
+      * Needs bEnableBatchTick in the project settings, otherwise ticks normally.
+      */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+    bool bBatchTick = false;
+
+    /**
+      * Run TickParallel on a worker thread, concurrently with the capabilities of the set it has no data conflict with.
+      * Requires ReadsData / WritesData and bParallelCapabilityTick in the project settings. Activation and the other
+      * lifecycle events stay on the game thread, TickParallel must only touch the declared data and this capability.
+      */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+    bool bParallelTick = false;
+
+    // Resolved by the component, 0 runs the variable delta tick.
+    float fixedTimestep = 0.0f;
+
+    int32 maxFixedSubsteps = 1;
+
     UPROPERTY(BlueprintReadOnly)
     ECapabilityExecuteSide executeSide = ECapabilityExecuteSide::Always;
 
     bool bIsCapabilityActive = false;
 
+    // Call At Construct, the values of the class default object become the shared class config.
+    void SetDataAccess(const TArray<TSubclassOf<UCapabilityDataComponent>>& InReads,
+                       const TArray<TSubclassOf<UCapabilityDataComponent>>& InWrites);
+
+    // Call At Construct
+    void SetLODTickIntervals(const TArray<float>& InIntervals);
+
+    // Adds Task as pending, Subscribe receives its id and returns the function undoing the subscription.
+    FCapabilityTaskHandle StartTask(FCapabilityTask&& Task, TFunctionRef<TFunction<void()>(uint64)> Subscribe);
+
+    // Removes the pending task Id, unsubscribes it and continues with its Then / Delegate.
+    void ResumeTask(uint64 Id);
+
 public:
     
-    UPROPERTY(EditDefaultsOnly, BlueprintReadWrite)
-    TArray<FName> Tags;
-    
     UCapabilityBase(const FObjectInitializer& ObjectInitializer);
 
+    virtual void BeginDestroy() override;
+
+    // Shared config of a capability class, created from its class default object on first use.
+    static const FCapabilityClassConfig& GetClassConfig(const UClass* Class);
+
+    // Bumped whenever reinstancing drops the cached class configs, lets holders of derived data rebuild it.
+    static uint32 GetClassConfigGeneration();
+
+    bool HasConfigOverride() const { return ConfigOverride.IsValid(); }
+
+    const TArray<FName>& GetTags() const {
+        return ReadConfigArray(&FCapabilityConfigOverride::Tags, &FCapabilityClassConfig::Tags, Tags);
+    }
+
+    UFUNCTION(BlueprintGetter)
+    TArray<FName> K2_GetTags() const { return GetTags(); }
+
+    UFUNCTION(BlueprintSetter)
+    void SetTags(const TArray<FName>& InTags);
+
+    const TArray<float>& GetLODTickIntervals() const {
+        return ReadConfigArray(&FCapabilityConfigOverride::LODTickIntervals, &FCapabilityClassConfig::LODTickIntervals,
+                               LODTickIntervals);
+    }
+
+    UFUNCTION(BlueprintGetter)
+    TArray<float> K2_GetLODTickIntervals() const { return GetLODTickIntervals(); }
+
     virtual void GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const override;
 
     UFUNCTION(BlueprintCallable)
@@ -76,9 +329,27 @@ public:
     UFUNCTION(BlueprintCallable)
     UCapabilityComponent* GetCapabilityComponent() const;
 
+    // Data component looked up through the capability component's class index.
+    template <typename T>
+    T* GetDataComponent() const;
+
+    // Same lookup for data this capability modifies, checked against WritesData by the data access validator.
+    template <typename T>
+    T* GetDataComponentForWrite() const;
+
     UFUNCTION(BlueprintCallable)
     FString GetString();
 
+    void SetOwningSetInstance(uint32 InSetInstanceID) { SetInstanceID = InSetInstanceID; }
+
+    // Set instance, then index in set. Orders event subscribers the same way on server and clients.
+    uint64 GetSetOrder() const { return (static_cast<uint64>(SetInstanceID) << 16) | static_cast<uint16>(IndexInSet); }
+
+    // Subscribes this capability to Channel on its component bus, unsubscribed at end play.
+    template <typename PayloadType>
+    FCapabilityEventSubscription SubscribeEvent(const TCapabilityEventChannel<PayloadType>& Channel,
+                                                TFunction<void(const PayloadType&)>&& Handler);
+
     /**
       * Configure the network execution mode of this ability.  
       * Should be called during construction.
@@ -118,14 +389,14 @@ public:
       * - Not sure? → Default to AuthorityOnly for safety
       */
     UFUNCTION(BlueprintCallable)
-    void SetExecuteSide(ECapabilityExecuteSide Mode) { executeSide = Mode; }
+    void SetExecuteSide(ECapabilityExecuteSide Mode);
     
     UFUNCTION(BlueprintCallable)
-    ECapabilityExecuteSide GetExecuteSide() { return executeSide; }
+    ECapabilityExecuteSide GetExecuteSide() const { return executeSide; }
     
     // Call At Construct
     UFUNCTION(BlueprintCallable)
-    void SetCanEverTick(bool bCanTick) { bCanEverTick = bCanTick; }
+    void SetCanEverTick(bool bCanTick);
 
     UFUNCTION(BlueprintCallable)
     bool GetCanEverTick() const { return bCanEverTick; }
@@ -135,12 +406,79 @@ public:
     void SetEnable(bool bEnable);
 
     UFUNCTION(BlueprintCallable)
-    void SetTickInterval(float InInterval) { tickInterval = InInterval; }
+    void SetTickInterval(float InInterval);
     
     UFUNCTION(BlueprintCallable)
     float GetTickInterval() const { return tickInterval; }
+
+    // Tick interval after the component tick LOD has been applied.
+    UFUNCTION(BlueprintCallable)
+    float GetEffectiveTickInterval() const;
+
+    void ApplyLODTier(int32 Tier, const FCapabilityLODTier* TierInfo);
+
+    UFUNCTION(BlueprintCallable)
+    bool GetUseFixedTimestep() const { return bFixedTimestep; }
+
+    UFUNCTION(BlueprintCallable)
+    void SetUseFixedTimestep(bool bEnable);
+
+    UFUNCTION(BlueprintCallable)
+    bool GetBatchTick() const { return bBatchTick; }
+
+    const TArray<TSubclassOf<UCapabilityDataComponent>>& GetReadsData() const {
+        return ReadConfigArray(&FCapabilityConfigOverride::ReadsData, &FCapabilityClassConfig::ReadsData, ReadsData);
+    }
+
+    const TArray<TSubclassOf<UCapabilityDataComponent>>& GetWritesData() const {
+        return ReadConfigArray(&FCapabilityConfigOverride::WritesData, &FCapabilityClassConfig::WritesData, WritesData);
+    }
+
+    bool HasDeclaredDataAccess() const { return !GetReadsData().IsEmpty() || !GetWritesData().IsEmpty(); }
+
+    /**
+      * Parallel tick needs declared data access, otherwise the capability ticks serially. So does an instance whose
+      * declarations differ from its class, since the tick layers of its set only know the class declarations.
+      */
+    bool GetParallelTick() const {
+        return bParallelTick && HasDeclaredDataAccess()
+            && (!ConfigOverride || (!ConfigOverride->ReadsData && !ConfigOverride->WritesData));
+    }
+
+    // Worker thread tick of bParallelTick capabilities, replaces Tick. Serial paths call it on the game thread.
+    virtual void TickParallel(float DeltaTime) {}
+
+    /**
+      * Development builds with CapabilitySystem.ValidateDataAccess: warns once when DataClass is not declared by this
+      * instance, in WritesData for a write and in ReadsData or WritesData for a read.
+      */
+    void ValidateDataAccess(const UClass* DataClass, bool bWrite) const;
+
+    bool IsBatchTicked() const { return BatchBucket != INDEX_NONE; }
+
+    // Step <= 0 switches back to the variable delta tick, a changed step drops the accumulated time.
+    void ApplyFixedTimestep(float Step, int32 MaxSubsteps);
+
+    // Step currently used by the fixed-step tick, 0 when ticking with the frame delta.
+    UFUNCTION(BlueprintCallable)
+    float GetFixedStepDelta() const;
+
+    bool IsLODSuspended() const { return bLODSuspended; }
+
+    /**
+      * Priority used when the world capability tick budget is exceeded.
+      * High is never deferred; Normal and Low are time-sliced round-robin and receive the accumulated delta.
+      * Can be overridden for a whole set in UCapabilitySet.
+      */
+    UFUNCTION(BlueprintCallable)
+    void SetTickPriority(ECapabilityTickPriority InPriority);
+
+    UFUNCTION(BlueprintCallable)
+    ECapabilityTickPriority GetTickPriority() const { return tickPriority; }
     
     bool ShouldRunOnThisSide() const;
+
+    static bool ShouldRunOnSide(AActor* Owner, ECapabilityExecuteSide Side);
     
     UFUNCTION(BlueprintCallable)
     void Activate();
@@ -151,6 +489,80 @@ public:
     UFUNCTION(BlueprintCallable)
     bool IsCapabilityActive() const { return bIsCapabilityActive; }
 
+    /**
+      * Evaluate ShouldActive / ShouldDeactivate right now instead of waiting for a tick.
+      * Respects the execute side and block tags (a blocked active capability is deactivated).
+      * Lets event driven capabilities stay out of the tick list.
+      */
+    UFUNCTION(BlueprintCallable)
+    void WakeUp();
+
+    /**
+      * Call Delegate after Delay seconds, then every Interval seconds when Interval > 0, without ticking.
+      * Cooldowns and durations should use this instead of counting down in Tick. Cleared automatically at end play.
+      */
+    UFUNCTION(BlueprintCallable)
+    FCapabilityTimerHandle SetCapabilityTimer(FCapabilityTimerDelegate Delegate, float Delay, float Interval = 0.0f);
+
+    FCapabilityTimerHandle SetCapabilityTimer(TFunction<void()>&& Callback, float Delay, float Interval = 0.0f);
+
+    /**
+      * WakeUp after Delay seconds (then every Interval seconds when Interval > 0), so a capability with
+      * bCanEverTick = false re-evaluates ShouldActive / ShouldDeactivate once its cooldown is over.
+      */
+    UFUNCTION(BlueprintCallable)
+    FCapabilityTimerHandle SetWakeUpTimer(float Delay, float Interval = 0.0f);
+
+    UFUNCTION(BlueprintCallable)
+    void ClearCapabilityTimer(UPARAM(ref) FCapabilityTimerHandle& Handle);
+
+    UFUNCTION(BlueprintCallable)
+    bool IsCapabilityTimerActive(const FCapabilityTimerHandle& Handle) const;
+
+    UFUNCTION(BlueprintCallable)
+    float GetCapabilityTimerRemaining(const FCapabilityTimerHandle& Handle) const;
+
+    /**
+      * Latent tasks: continue with Then once the condition is met and cost nothing while waiting, so sequenced logic
+      * (wait, then act) needs no state machine in Tick. Chain steps by starting the next wait from Then.
+      * Pending tasks are cancelled on Deactivate and at end play.
+      */
+    UFUNCTION(BlueprintCallable)
+    FCapabilityTaskHandle WaitDelay(float Seconds, FCapabilityTaskDelegate Then);
+
+    FCapabilityTaskHandle WaitDelay(float Seconds, TFunction<void()>&& Then);
+
+    // Continues right away, returning an invalid handle, when Tag is not blocked.
+    UFUNCTION(BlueprintCallable)
+    FCapabilityTaskHandle WaitTagUnblocked(FName Tag, FCapabilityTaskDelegate Then);
+
+    FCapabilityTaskHandle WaitTagUnblocked(FName Tag, TFunction<void()>&& Then);
+
+    // Continues on the next UCapabilityDataComponent::NotifyDataChanged of Data for Key, None matches any key.
+    UFUNCTION(BlueprintCallable)
+    FCapabilityTaskHandle WaitDataNotify(UCapabilityDataComponent* Data, FName Key, FCapabilityTaskDelegate Then);
+
+    FCapabilityTaskHandle WaitDataNotify(UCapabilityDataComponent* Data, FName Key, TFunction<void()>&& Then);
+
+    UFUNCTION(BlueprintCallable)
+    void CancelTask(UPARAM(ref) FCapabilityTaskHandle& Handle);
+
+    UFUNCTION(BlueprintCallable)
+    bool IsTaskPending(const FCapabilityTaskHandle& Handle) const;
+
+    /**
+      * Custom state for UCapabilityComponent::SaveStateSnapshot / RestoreStateSnapshot, the same code path reads and
+      * writes (check Ar.IsLoading()). Snapshots never leave the process, keep it to plain values and avoid allocating.
+      * Restoring does not call OnActivated / OnDeactivated.
+      */
+    virtual void SerializeRollbackState(FArchive& Ar) {}
+
+    /**
+      * Opt-in persistent state for UCapabilityComponent::SaveLoadout / RestoreLoadout, read back right after BeginPlay
+      * of a restored set. Unlike rollback state it is written to disk, so version your data.
+      */
+    virtual void SerializeLoadoutState(FArchive& Ar) {}
+
     UFUNCTION(BlueprintCallable)
     bool IsSideLocalControlled() const;
 
@@ -161,7 +573,7 @@ public:
     bool IsSideAllClients() const;
 
     UFUNCTION(BlueprintCallable)
-    void BlockCapability(const FName& Tag, UObject* From);
+    void BlockCapability(const FName& Tag, UObject* From, float Duration = 0.0f);
 
     UFUNCTION(BlueprintCallable)
     void UnBlockCapability(const FName& Tag, UObject* From);
@@ -10,3 +10,24 @@ T* UCapabilityBase::GetOwner() const {
     if (!Manager) return nullptr;
     return Cast<T>(Manager->GetOwner());
 }
+
+template <typename T>
+T* UCapabilityBase::GetDataComponent() const {
+    const auto Manager = GetCapabilityComponent();
+    return Manager ? Manager->template GetDataComponent<T>() : nullptr;
+}
+
+template <typename T>
+T* UCapabilityBase::GetDataComponentForWrite() const {
+    const auto Manager = GetCapabilityComponent();
+    return Manager ? Manager->template GetDataComponentForWrite<T>() : nullptr;
+}
+
+template <typename PayloadType>
+FCapabilityEventSubscription UCapabilityBase::SubscribeEvent(const TCapabilityEventChannel<PayloadType>& Channel,
+                                                             TFunction<void(const PayloadType&)>&& Handler) {
+    const auto Manager = GetCapabilityComponent();
+    if (!Manager) return FCapabilityEventSubscription();
+    bHasEventSubscriptions = true;
+    return Manager->SubscribeEvent(Channel, this, MoveTemp(Handler));
+}
@@ -0,0 +1,74 @@
+﻿// Copyright ysion(LZY). All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CapabilityCommon.h"
+#include "CapabilityBatchTick.generated.h"
+
+class UCapabilityBase;
+class UCapabilityComponent;
+
+DECLARE_CYCLE_STAT(TEXT("Capability Batch Tick"), STAT_Capability_BatchTick, STATGROUP_Capability);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Batch Ticking Capability Count"), STAT_BatchTickingCapabilityCount, STATGROUP_Capability);
+
+/**
+ * Ticks the capabilities marked bBatchTick class by class across every component of the world, so the code of one
+ * class stays in the instruction cache while all of its instances run back to back from a contiguous array.
+ * Runs after the actor tick groups, without tick budget deferral. Capabilities of inactive components or of actors
+ * with tick disabled are skipped. Only created when bEnableBatchTick is set.
+ */
+UCLASS()
+class CAPABILITYSYSTEM_API UCapabilityBatchTickSubsystem : public UTickableWorldSubsystem {
+    GENERATED_BODY()
+public:
+
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+    virtual void Deinitialize() override;
+
+    virtual void Tick(float DeltaTime) override;
+
+    virtual bool IsTickable() const override { return NumInstances > 0; }
+
+    virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UCapabilityBatchTickSubsystem, STATGROUP_Capability); }
+
+    // Both are no-ops when the capability already is in the requested state.
+    void Register(UCapabilityBase* Capability, UCapabilityComponent* Component);
+
+    void Unregister(UCapabilityBase* Capability);
+
+    UFUNCTION(BlueprintCallable)
+    int32 GetNumBatchedClasses() const { return Buckets.Num(); }
+
+    UFUNCTION(BlueprintCallable)
+    int32 GetNumBatchedCapabilities() const { return NumInstances; }
+
+private:
+
+    // Weak, an owner torn down without unregistering leaves a stale entry that the next tick drops.
+    struct FBatchEntry {
+        TWeakObjectPtr<UCapabilityBase> Capability;
+
+        TWeakObjectPtr<UCapabilityComponent> Component;
+    };
+
+    struct FBatchBucket {
+        const UClass* Class = nullptr;
+
+        TArray<FBatchEntry> Entries;
+    };
+
+    // Drops the unregistered and stale entries and reassigns the slots of the ones that moved.
+    void CompactBuckets();
+
+    TMap<const UClass*, int32> BucketIndex;
+
+    TArray<FBatchBucket> Buckets;
+
+    int32 NumInstances = 0;
+
+    bool bIsTicking = false;
+
+    bool bHasRemoved = false;
+};
@@ -0,0 +1,113 @@
+﻿// Copyright ysion(LZY). All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CapabilityCommon.h"
+#include "CapabilityBlockChannel.generated.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Capability Channel Blocks"), STAT_CapabilityChannelBlocks, STATGROUP_Capability);
+
+USTRUCT()
+struct FCapabilityChannelBlock {
+    GENERATED_BODY()
+
+    UPROPERTY()
+    FName Channel;
+
+    UPROPERTY()
+    FName Tag;
+
+    bool operator==(const FCapabilityChannelBlock& Other) const {
+        return Channel == Other.Channel && Tag == Other.Tag;
+    }
+
+    friend uint32 GetTypeHash(const FCapabilityChannelBlock& Block) {
+        return HashCombine(GetTypeHash(Block.Channel), GetTypeHash(Block.Tag));
+    }
+};
+
+/**
+ * Replicates the blocked tags of every block channel in the world, one entry per channel / tag.
+ * Block sources stay on the server, a channel change replicates this single actor regardless of subscriber count.
+ */
+UCLASS(NotPlaceable, Transient)
+class CAPABILITYSYSTEM_API ACapabilityBlockChannelActor : public AInfo {
+    GENERATED_BODY()
+
+public:
+    ACapabilityBlockChannelActor();
+
+    // Server only, true if the channel / tag pair became blocked or unblocked.
+    bool AddSource(const FCapabilityChannelBlock& Block, UObject* From);
+
+    bool RemoveSource(const FCapabilityChannelBlock& Block, const UObject* From);
+
+    const TArray<FCapabilityChannelBlock>& GetBlocks() const { return Blocks; }
+
+    virtual void BeginPlay() override;
+
+    virtual void GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const override;
+
+protected:
+    UPROPERTY(ReplicatedUsing = OnRep_Blocks)
+    TArray<FCapabilityChannelBlock> Blocks;
+
+    TMap<FCapabilityChannelBlock, TArray<TWeakObjectPtr<UObject>>> Sources;
+
+    UFUNCTION()
+    void OnRep_Blocks();
+};
+
+/**
+ * Block channels: block a tag for every capability component subscribed to a channel (a team, a zone, or the
+ * implicit Global channel) in one server call. Components compare GetRevision with their cached copy and only
+ * rebuild their channel blocked tags after a change. Only created when bEnableBlockChannels is set.
+ */
+UCLASS()
+class CAPABILITYSYSTEM_API UCapabilityBlockChannelSubsystem : public UWorldSubsystem {
+    GENERATED_BODY()
+
+public:
+    // Every capability component is subscribed to this channel.
+    static const FName GlobalChannel;
+
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+    // Server only.
+    UFUNCTION(BlueprintCallable)
+    void BlockChannel(FName Channel, FName Tag, UObject* From);
+
+    // Server only.
+    UFUNCTION(BlueprintCallable)
+    void UnBlockChannel(FName Channel, FName Tag, UObject* From);
+
+    UFUNCTION(BlueprintCallable)
+    bool IsChannelTagBlocked(FName Channel, FName Tag) const;
+
+    // Appends the tags blocked on any of Channels.
+    void GatherBlockedTags(const TArray<FName>& Channels, TSet<FName>& OutTags) const;
+
+    bool HasAnyBlocks() const { return ChannelActor && !ChannelActor->GetBlocks().IsEmpty(); }
+
+    // Bumped on every channel change, starts at 1.
+    uint32 GetRevision() const { return Revision; }
+
+    void RegisterChannelActor(ACapabilityBlockChannelActor* Actor);
+
+    void NotifyChannelsChanged() {
+        Revision++;
+        OnChannelsChanged.Broadcast();
+    }
+
+    FSimpleMulticastDelegate OnChannelsChanged;
+
+private:
+    UPROPERTY(Transient)
+    TObjectPtr<ACapabilityBlockChannelActor> ChannelActor;
+
+    uint32 Revision = 1;
+};
@@ -2,5 +2,5 @@
 #pragma once
 
 #include "CoreMinimal.h"
-DECLARE_LOG_CATEGORY_EXTERN(CapabilitySystemLog, Log, All);
+CAPABILITYSYSTEM_API DECLARE_LOG_CATEGORY_EXTERN(CapabilitySystemLog, Log, All);
 DECLARE_STATS_GROUP(TEXT("Capability"), STATGROUP_Capability, STATCAT_Capability)
\ No newline at end of file
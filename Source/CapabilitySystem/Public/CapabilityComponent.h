@@ -4,12 +4,28 @@
 #include "CoreMinimal.h"
 #include "CapabilityAsset.h"
 #include "CapabilityCommon.h"
+#include "CapabilityLite.h"
+#include "CapabilityInputBuffer.h"
+#include "CapabilitySnapshot.h"
+#include "CapabilityLoadout.h"
+#include "CapabilityTimingWheel.h"
+#include "CapabilityEventBus.h"
 #include "Components/ActorComponent.h"
 #include "CapabilityComponent.generated.h"
 
+class UCapabilityTickBudgetSubsystem;
+class UCapabilityBatchTickSubsystem;
+class UCapabilityLODSubsystem;
+class UCapabilityBlockChannelSubsystem;
+struct FCapabilityLODTier;
+struct FStreamableHandle;
+
 DECLARE_CYCLE_STAT(TEXT("Capability Tick"), STAT_Capability_Tick, STATGROUP_Capability)
 DECLARE_DWORD_COUNTER_STAT(TEXT("Ticking Capability Count"), STAT_TickingCapabilityCount, STATGROUP_Capability)
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FCapabilityLoadoutRestoredSignature);
+DECLARE_MULTICAST_DELEGATE(FCapabilityBlockInfoChangedSignature);
+
 UENUM(BlueprintType)
 enum class ECapabilityComponentMode : uint8 {
     Authority UMETA(DisplayName = "Authority"),
@@ -52,6 +68,31 @@ public:
     
     UPROPERTY(EditDefaultsOnly, Category = "Capability Set Config")
     TArray<TSoftObjectPtr<UCapabilitySet>> CapabilitySetPresets;
+
+    // Let the world tick LOD (UCapabilityLODSubsystem) slow down or suspend capabilities of this component.
+    UPROPERTY(EditAnywhere, Category = "Capability Tick LOD")
+    bool bAllowTickLOD = true;
+
+    // On EndPlay, hand data components and capability objects to UCapabilityTeardownSubsystem (if enabled).
+    UPROPERTY(EditAnywhere, Category = "Capability Teardown")
+    bool bAllowDeferredTeardown = true;
+
+    // Block channels this component follows in addition to the implicit Global channel (needs bEnableBlockChannels).
+    // Server-owned outside Local mode and replicated to clients.
+    UPROPERTY(EditAnywhere, ReplicatedUsing = OnRep_BlockChannels, Category = "Capability Block Channels")
+    TArray<FName> BlockChannels;
+
+    // Run every capability of this component in fixed-step mode, not only the ones with bFixedTimestep.
+    UPROPERTY(EditAnywhere, Category = "Capability Fixed Timestep")
+    bool bForceFixedTimestep = false;
+
+    // Fixed step (s) for this component, <= 0 uses the project setting.
+    UPROPERTY(EditAnywhere, Category = "Capability Fixed Timestep", meta = (ClampMin = "0.0", Units = "s"))
+    float FixedTimestepOverride = 0.0f;
+
+    // Catch-up bound for this component, <= 0 uses the project setting.
+    UPROPERTY(EditAnywhere, Category = "Capability Fixed Timestep", meta = (ClampMin = "0"))
+    int32 MaxFixedSubstepsOverride = 0;
     
     UCapabilityComponent();
 
@@ -82,34 +123,242 @@ public:
     virtual void OnControllerChanged(APlayerController* NewController, UEnhancedInputComponent* InputComponent);
 
     virtual void OnControllerRemoved();
+
+    UFUNCTION(BlueprintCallable)
+    int32 GetLODTier() const { return LODTier; }
+
+    void SetLODTier(int32 Tier, const FCapabilityLODTier* TierInfo);
+
+    // Fed by UCapabilityInput action bindings for the InputBufferTriggerEvents of the project settings,
+    // the same action / trigger event is recorded once per frame.
+    void RecordInputEvent(const UInputAction* Action, ETriggerEvent TriggerEvent, const FInputActionValue& Value);
+
+    // True if Action fired TriggerEvent within the last WithinSeconds and was not consumed yet.
+    UFUNCTION(BlueprintCallable)
+    bool WasInputTriggeredWithin(const UInputAction* Action, float WithinSeconds,
+                                 ETriggerEvent TriggerEvent = ETriggerEvent::Started) const;
+
+    // Like WasInputTriggeredWithin, but marks the newest matching event consumed so it only fires one combo step.
+    UFUNCTION(BlueprintCallable)
+    bool ConsumeInput(const UInputAction* Action, float WithinSeconds, FCapabilityInputEvent& OutEvent,
+                      ETriggerEvent TriggerEvent = ETriggerEvent::Started);
+
+    UFUNCTION(BlueprintCallable)
+    void ClearInputBuffer() { InputBuffer.Reset(); }
+
+    /**
+      * Rollback support: write the activation / tick flags and accumulators, SerializeRollbackState of every capability
+      * and BlockInfo into the snapshot ring (RollbackSnapshotFrames). Saving a frame drops any newer ones.
+      * Lite capabilities are not captured.
+      */
+    UFUNCTION(BlueprintCallable)
+    void SaveStateSnapshot(int32 Frame);
+
+    // Fails without changing anything if Frame is not in the ring or capability sets were added / removed since it was saved.
+    // Tags the restored BlockInfo newly blocks deactivate their capabilities, as BlockCapability does.
+    UFUNCTION(BlueprintCallable)
+    bool RestoreStateSnapshot(int32 Frame);
+
+    // Tick the capabilities once outside the component tick, without the tick budget, to resimulate after a restore.
+    UFUNCTION(BlueprintCallable)
+    void ResimulateTick(float DeltaTime);
+
+    UFUNCTION(BlueprintCallable)
+    void ClearStateSnapshots() { StateSnapshots.Reset(); }
+
+    /**
+      * Binary loadout for save games and streaming: capability sets in add order, blocked tags and the
+      * SerializeLoadoutState output of every capability. Only the authority / local side owns a loadout.
+      */
+    UFUNCTION(BlueprintCallable)
+    void SaveLoadout(TArray<uint8>& OutData);
+
+    /**
+      * Loads every set of the loadout asynchronously, then adds them in one batch (one tick list rebuild),
+      * restores capability state after BeginPlay and blocks the saved tags with this component as source. Sets already on the component are skipped. OnLoadoutRestored fires when done.
+      */
+    UFUNCTION(BlueprintCallable)
+    bool RestoreLoadout(const TArray<uint8>& Data);
+
+    UFUNCTION(BlueprintCallable)
+    bool IsRestoringLoadout() const { return LoadoutHandle.IsValid(); }
+
+    UPROPERTY(BlueprintAssignable)
+    FCapabilityLoadoutRestoredSignature OnLoadoutRestored;
+
+    // A tag lost its last block source, BlockInfo replicated or BlockChannels changed. Listeners check the tags they care about again.
+    FCapabilityBlockInfoChangedSignature OnBlockInfoChanged;
+
+    // Answered from the tag index, rebuilt lazily after capability sets or tags change.
+    UFUNCTION(BlueprintCallable)
+    bool IsAnyActiveWithTag(FName Tag) const;
+
+    UFUNCTION(BlueprintCallable)
+    void GetCapabilitiesByTag(FName Tag, TArray<UCapabilityBase*>& OutCapabilities) const;
+
+    // Capabilities of the current side carrying Tag, valid until the next capability set or tag change.
+    TConstArrayView<TWeakObjectPtr<UCapabilityBase>> FindCapabilitiesByTag(FName Tag) const;
+
+    // Server only unless the component is Local, clients receive the membership through replication.
+    UFUNCTION(BlueprintCallable)
+    void JoinBlockChannel(FName Channel);
+
+    UFUNCTION(BlueprintCallable)
+    void LeaveBlockChannel(FName Channel);
+
+    // Seconds until a timed block of Tag from From expires, 0 if it is not timed.
+    UFUNCTION(BlueprintCallable)
+    float GetBlockRemainingTime(FName Tag, UObject* From) const;
+
+    // Called by UCapabilityTimerSubsystem. Removes the source locally, on clients the server state replicates over it.
+    void OnTimedBlockExpired(const FName& Tag, const TWeakObjectPtr<UObject>& From);
+
+    // First capability of Class (or a subclass) in set order, from the class index.
+    UFUNCTION(BlueprintCallable, meta = (DeterminesOutputType = "Class"))
+    UCapabilityBase* FindCapabilityByClass(TSubclassOf<UCapabilityBase> Class) const;
+
+    // Data component of Class (or a subclass) spawned by a capability set, replaces GetOwner()->FindComponentByClass.
+    // Validated as a read by the data access validator.
+    UFUNCTION(BlueprintCallable, meta = (DeterminesOutputType = "Class"))
+    UCapabilityDataComponent* GetDataComponentByClass(TSubclassOf<UCapabilityDataComponent> Class) const;
+
+    // Same lookup for callers that modify the data, validated against WritesData.
+    UFUNCTION(BlueprintCallable, meta = (DeterminesOutputType = "Class"))
+    UCapabilityDataComponent* GetDataComponentForWrite(TSubclassOf<UCapabilityDataComponent> Class) const;
+
+    template <typename T>
+    T* FindCapability() const {
+        static_assert(TIsDerivedFrom<T, UCapabilityBase>::Value, "T must be a capability");
+        return static_cast<T*>(FindCapabilityByClass(T::StaticClass()));
+    }
+
+    template <typename T>
+    T* GetDataComponent() const {
+        static_assert(TIsDerivedFrom<T, UCapabilityDataComponent>::Value, "T must be a capability data component");
+        return static_cast<T*>(GetDataComponentByClass(T::StaticClass()));
+    }
+
+    template <typename T>
+    T* GetDataComponentForWrite() const {
+        static_assert(TIsDerivedFrom<T, UCapabilityDataComponent>::Value, "T must be a capability data component");
+        return static_cast<T*>(GetDataComponentForWrite(T::StaticClass()));
+    }
+
+    /**
+      * Handler called for every event of Channel, ordered by set then index in set when Listener is a capability
+      * (other listeners run last). Dropped once Listener is destroyed, capabilities are unsubscribed at end play.
+      */
+    template <typename PayloadType>
+    FCapabilityEventSubscription SubscribeEvent(const TCapabilityEventChannel<PayloadType>& Channel,
+                                                const UObject* Listener,
+                                                TFunction<void(const PayloadType&)>&& Handler) {
+        return EventBus.Subscribe(Channel, Listener, GetEventOrder(Listener), MoveTemp(Handler));
+    }
+
+    void UnsubscribeEvent(FCapabilityEventSubscription& Subscription) { EventBus.Unsubscribe(Subscription); }
+
+    void UnsubscribeEvents(const UObject* Listener) { EventBus.UnsubscribeAll(Listener); }
+
+    // Delivered to the subscribers right away.
+    template <typename PayloadType>
+    void SendEvent(const TCapabilityEventChannel<PayloadType>& Channel, const PayloadType& Payload) {
+        EventBus.Send(Channel, Payload);
+    }
+
+    // Delivered at the start of the next component tick, before any capability ticks.
+    template <typename PayloadType>
+    void PostEvent(const TCapabilityEventChannel<PayloadType>& Channel, const PayloadType& Payload) {
+        EventBus.Post(Channel, Payload);
+        if (!IsComponentTickEnabled()) SetComponentTickEnabled(true);
+    }
     
 protected:
     friend class UCapabilityBase;
+    friend struct FCapabilityLite;
+    friend class UCapabilityMetaHead;
+    friend class UCapabilityBatchTickSubsystem;
     
     UPROPERTY()
     TArray<TObjectPtr<UCapabilityBase>> TickList{};
+
+    // Ticking capabilities handed to the batch tick subsystem instead of TickList, kept for LOD updates.
+    UPROPERTY()
+    TArray<TObjectPtr<UCapabilityBase>> BatchTickList{};
+
+    // Block check and NativeTick for a capability ticked outside TickList, never deferred by the tick budget.
+    void TickDetachedCapability(UCapabilityBase* Capability, float DeltaTime);
+
+    // (TickList start, count) of the capabilities ticked concurrently, one range per tick layer of a set.
+    TArray<TPair<int32, int32>> ParallelRanges;
+
+    struct FCapabilityParallelWork {
+        UCapabilityBase* Capability = nullptr;
+
+        float Delta = 0.0f;
+
+        int32 Steps = 0;
+    };
+
+    // Reused scratch of the range being ticked.
+    TArray<FCapabilityParallelWork> ParallelWork;
+
+    // Block, LOD and budget checks of TickList entries, false when the capability does not tick this frame.
+    bool PrepareCapabilityTick(UCapabilityBase* Capability, float DeltaTime, bool bUseBudget, bool bOverBudget,
+                               float& OutDelta);
+
+    void RunParallelWork();
+
+    FCapabilityEventBus EventBus;
+
+    static uint64 GetEventOrder(const UObject* Listener);
     
     uint32 InstanceGen = 0;
     
     bool bShouldTickUpdateThisFrame = false;
 
+    UPROPERTY(Transient)
+    TObjectPtr<UCapabilityTickBudgetSubsystem> TickBudget;
+
+    UPROPERTY(Transient)
+    TObjectPtr<UCapabilityBatchTickSubsystem> BatchTick;
+
+    UPROPERTY(Transient)
+    TObjectPtr<UCapabilityBlockChannelSubsystem> BlockChannelSubsystem;
+
+    // Tags blocked through BlockChannels, refreshed when the channel revision moves.
+    mutable TSet<FName> ChannelBlockedTags;
+
+    mutable uint32 ChannelRevision = 0;
+
+    bool IsChannelTagBlocked(const TArray<FName>& Tags) const;
+
+    void RefreshChannelBlockedTags() const;
+
+    // Bound to the subsystem's OnChannelsChanged, runs on the server and on clients once the blocks replicate.
+    void OnChannelBlocksChanged();
+
+    // False with a warning on clients of a replicated component.
+    bool CanChangeBlockChannels(const FName& Channel) const;
+
+    int32 LODTier = 0;
+
+    const FCapabilityLODTier* LODTierInfo = nullptr;
+
     UPROPERTY(ReplicatedUsing=OnRep_CapabilitySetListOnServer)
     TArray<FCapabilityObjectRefSet> CapabilitySetListOnServer{};
 
-    UPROPERTY(Replicated)
+    UPROPERTY(ReplicatedUsing=OnRep_BlockInfo)
     TArray<FCapabilityBlockInfo> BlockInfo;
 
-    UPROPERTY()
-    TSet<FCapabilityObjectRefSet> LastClientCapabilities;
+    // Instance IDs of the sets seen in the last CapabilitySetListOnServer replication.
+    TSet<uint32> LastClientCapabilities;
 
     UPROPERTY()
     TArray<FCapabilityObjectRefSet> CapabilitiesOnClient;
 
-    UPROPERTY()
-    TSet<FCapabilityObjectRefSet> ToRemoveCollect;
+    TSet<uint32> ToRemoveCollect;
 
-    UPROPERTY()
-    TSet<FCapabilityObjectRefSet> ToAddCollect;
+    TSet<uint32> ToAddCollect;
 
     UPROPERTY()
     TObjectPtr<APlayerController> CachedController;
@@ -119,11 +368,73 @@ protected:
     
     UPROPERTY()
     TArray<FCapabilityObjectRefSet> LocalCapabilities;
+
+    UPROPERTY(Transient)
+    TArray<FCapabilityLiteSet> LiteCapabilitySets;
+
+    TArray<FCapabilityLite*> LiteTickList;
     
     bool bNeedSyncClientCaps = false;
 
     bool bIsShuttingDown = false;
 
+    UPROPERTY(Transient)
+    FCapabilityInputBuffer InputBuffer;
+
+    FCapabilityStateRing StateSnapshots;
+
+    FCapabilityLoadout PendingLoadout;
+
+    TSharedPtr<FStreamableHandle> LoadoutHandle;
+
+    // Lookup indices of the current side, rebuilt lazily on the same triggers as TickList.
+    // Pure caches, the set arrays own the objects, so entries are weak and never seen by GC.
+    mutable TMap<FName, TArray<TWeakObjectPtr<UCapabilityBase>>> TagIndex;
+
+    // Keyed by every class from the concrete class up to the base, the first instance in set order wins.
+    mutable TMap<const UClass*, TWeakObjectPtr<UCapabilityBase>> CapabilityClassIndex;
+
+    mutable TMap<const UClass*, TWeakObjectPtr<UCapabilityDataComponent>> DataComponentClassIndex;
+
+    mutable bool bLookupIndexDirty = true;
+
+    void EnsureLookupIndex() const;
+
+    UCapabilityDataComponent* FindDataComponent(const UClass* Class, bool bWrite) const;
+
+    // Adds From as a source of Tag, true if Tag was not blocked before.
+    bool AddBlockSource(const FName& Tag, UObject* From);
+
+    // Removes From and dead sources of Tag, true if BlockInfo changed.
+    bool RemoveBlockSource(const FName& Tag, const UObject* From);
+
+    using FTimedBlockKey = TPair<FName, TWeakObjectPtr<UObject>>;
+
+    // Expiry timers of blocks added with a duration, a later block or unblock of the same source replaces them.
+    TMap<FTimedBlockKey, FCapabilityTimingWheelHandle> TimedBlocks;
+
+    void SetBlockExpiry(const FName& Tag, UObject* From, float Duration);
+
+    void CancelAllBlockExpiries();
+
+    // Deactivates the capabilities of a newly blocked tag right away instead of on their next tick.
+    void DeactivateCapabilitiesWithTag(const FName& Tag);
+
+    // UpdateTickStatus only marks the tick list dirty while > 0.
+    int32 TickStatusBatchDepth = 0;
+
+    void ApplyPendingLoadout();
+
+    uint32 ComputeSnapshotTopology() const;
+
+    void SerializeBlockInfo(FArchive& Ar);
+
+    // Runs the tick list, the tick budget may defer low priority capabilities only if bAllowDeferral.
+    void TickCapabilities(float DeltaTime, bool bAllowDeferral);
+
+    // Destroys data components and marks capability objects as garbage, back to front. Deferred while shutting down if allowed.
+    void ReleaseCapabilitySets(TArray<FCapabilityObjectRefSet>& Sets);
+
     virtual void BeginPlay() override;
     
     virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
@@ -134,12 +445,25 @@ protected:
 
     virtual void NotifyShouldUpdateTickStatusNextFrame();
 
-    virtual void BlockCapability(const FName& Tag, UObject* From);
+    bool IsTagsBlocked(const TArray<FName>& Tags) const;
+
+    FCapabilityLiteContext MakeLiteContext() { return FCapabilityLiteContext{this, GetOwner()}; }
+
+    void CreateLiteCapabilities(uint32 InstanceID, const UCapabilitySet* SetPtr);
+
+    void RemoveLiteCapabilities(uint32 InstanceID);
+
+    void RemoveAllLiteCapabilities();
+
+    const FCapabilityLiteSet* FindLiteCapabilities(uint32 InstanceID) const;
+
+    // Duration > 0 removes this source again after Duration seconds, driven by UCapabilityTimerSubsystem.
+    virtual void BlockCapability(const FName& Tag, UObject* From, float Duration = 0.0f);
     
     virtual void UnBlockCapability(const FName& Tag, UObject* From);
 
     UFUNCTION(Server, Reliable)
-    void ServerBlockCapability(const FName& Tag, UObject* From);
+    void ServerBlockCapability(const FName& Tag, UObject* From, float Duration);
 
     UFUNCTION(Server, Reliable)
     void ServerUnBlockCapability(const FName& Tag, UObject* From);
@@ -148,6 +472,12 @@ protected:
     
     void SyncCapabilityClient();
 
+    // AllClients capability without RPCs, which a dedicated server never needs, judged from the class defaults.
+    static bool IsClientOnlyCapabilityClass(TSubclassOf<UCapabilityBase> Class);
+
+    // Creates the ClientOnlyClasses of the set's meta head and merges them into ObjectRefs in set order.
+    void SpawnClientOnlyCapabilities(FCapabilityObjectRefSet& ClientSet, const UCapabilitySet* SetPtr);
+
     TArray<FCapabilityObjectRefSet>& GetSideCapabilityArray() {
         if (ComponentMode == ECapabilityComponentMode::Local) return LocalCapabilities;
         const bool bNowAuthority = GetOwner() ? GetOwner()->HasAuthority() : false;
@@ -163,5 +493,11 @@ protected:
     UFUNCTION()
     void OnRep_CapabilitySetListOnServer();
 
+    UFUNCTION()
+    void OnRep_BlockInfo() { OnBlockInfoChanged.Broadcast(); }
+
+    UFUNCTION()
+    void OnRep_BlockChannels();
+
     virtual void GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const override;
 };
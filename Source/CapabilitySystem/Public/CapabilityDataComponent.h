@@ -7,6 +7,8 @@
 
 class UCapabilityMetaHead;
 
+DECLARE_MULTICAST_DELEGATE_OneParam(FCapabilityDataNotifySignature, FName);
+
 UCLASS(Blueprintable, Abstract)
 class UCapabilityDataComponent : public UActorComponent {
     GENERATED_BODY()
@@ -20,4 +22,10 @@ public:
     virtual void GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const override;
     
     virtual void PreDestroyFromReplication() override;
+
+    // Resumes capabilities waiting in WaitDataNotify, call it from setters and OnRep functions.
+    UFUNCTION(BlueprintCallable)
+    void NotifyDataChanged(FName Key) { OnDataNotify.Broadcast(Key); }
+
+    FCapabilityDataNotifySignature OnDataNotify;
 };
\ No newline at end of file
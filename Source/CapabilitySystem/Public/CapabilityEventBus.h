@@ -0,0 +1,166 @@
+﻿// Copyright ysion(LZY). All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CapabilityCommon.h"
+
+DECLARE_CYCLE_STAT(TEXT("Capability Event Dispatch"), STAT_Capability_EventDispatch, STATGROUP_Capability);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Capability Events Sent"), STAT_CapabilityEventsSent, STATGROUP_Capability);
+DECLARE_MEMORY_STAT(TEXT("Capability Event Bus Memory"), STAT_CapabilityEventBusMemory, STATGROUP_Capability);
+
+/**
+ * Process wide ids of event channels, registered once (usually by a static TCapabilityEventChannel) and used to
+ * index the subscriber lists of every FCapabilityEventBus. Registering a name twice returns the same id.
+ */
+struct CAPABILITYSYSTEM_API FCapabilityEventRegistry {
+    static int32 Register(FName Name);
+
+    static FName GetChannelName(int32 Id);
+};
+
+/**
+ * Typed channel of one message type, declare it once at namespace scope:
+ * static const TCapabilityEventChannel<FLandedEvent> LandedChannel(TEXT("Landed"));
+ */
+template <typename PayloadType>
+struct TCapabilityEventChannel {
+    explicit TCapabilityEventChannel(FName Name) : Id(FCapabilityEventRegistry::Register(Name)) {}
+
+    int32 GetId() const { return Id; }
+
+private:
+    int32 Id;
+};
+
+struct FCapabilityEventSubscription {
+    int32 Channel = INDEX_NONE;
+
+    uint64 Id = 0;
+
+    bool IsValid() const { return Id != 0; }
+
+    void Invalidate() {
+        Channel = INDEX_NONE;
+        Id = 0;
+    }
+};
+
+/**
+ * Typed message bus of one capability component. Subscribers are kept sorted by Order (set instance, then index in
+ * set for capabilities), payloads are passed by reference. Posted events are copied into a byte queue that is reused
+ * between flushes, so sending and posting do not allocate once the queue has grown.
+ */
+struct CAPABILITYSYSTEM_API FCapabilityEventBus {
+    FCapabilityEventBus() = default;
+
+    FCapabilityEventBus(const FCapabilityEventBus&) = delete;
+
+    FCapabilityEventBus& operator=(const FCapabilityEventBus&) = delete;
+
+    ~FCapabilityEventBus() { Reset(); }
+
+    template <typename PayloadType>
+    FCapabilityEventSubscription Subscribe(const TCapabilityEventChannel<PayloadType>& Channel, const UObject* Listener,
+                                           uint64 Order, TFunction<void(const PayloadType&)>&& Handler) {
+        return AddSubscriber(Channel.GetId(), Listener, Order, [Handler = MoveTemp(Handler)](const void* Payload) {
+            Handler(*static_cast<const PayloadType*>(Payload));
+        });
+    }
+
+    // Delivered right away to every subscriber of Channel.
+    template <typename PayloadType>
+    void Send(const TCapabilityEventChannel<PayloadType>& Channel, const PayloadType& Payload) {
+        Dispatch(Channel.GetId(), &Payload);
+    }
+
+    // Copied into the queue and delivered by the next FlushDeferred.
+    template <typename PayloadType>
+    void Post(const TCapabilityEventChannel<PayloadType>& Channel, const PayloadType& Payload) {
+        static_assert(alignof(PayloadType) <= 16, "Event payloads are limited to 16 byte alignment");
+        void* Memory = AllocDeferred(Channel.GetId(), sizeof(PayloadType), alignof(PayloadType),
+                                     [](void* Ptr) { static_cast<PayloadType*>(Ptr)->~PayloadType(); });
+        new(Memory) PayloadType(Payload);
+    }
+
+    // Delivers the queued events in post order, events posted meanwhile wait for the next flush.
+    void FlushDeferred();
+
+    bool HasDeferred() const { return !Queued.Events.IsEmpty(); }
+
+    void Unsubscribe(FCapabilityEventSubscription& Subscription);
+
+    void UnsubscribeAll(const UObject* Listener);
+
+    // Drops every subscriber and queued event. Called from a handler, the subscribers are only skipped and the
+    // remaining flushed events dropped until the outermost dispatch or flush returns.
+    void Reset();
+
+    SIZE_T GetAllocatedSize() const;
+
+private:
+    struct FSubscriber {
+        uint64 Id = 0;
+
+        uint64 Order = 0;
+
+        TWeakObjectPtr<const UObject> Listener;
+
+        TFunction<void(const void*)> Handler;
+
+        // Unsubscribed while dispatching, erased once the outermost dispatch returns.
+        bool bRemoved = false;
+    };
+
+    struct FQueuedEvent {
+        int32 Channel = INDEX_NONE;
+
+        int32 Offset = 0;
+
+        void (*Destroy)(void*) = nullptr;
+    };
+
+    struct FEventQueue {
+        TArray<uint8> Bytes;
+
+        TArray<FQueuedEvent> Events;
+
+        // Destroys the payloads, keeps the allocations.
+        void Clear();
+    };
+
+    FCapabilityEventSubscription AddSubscriber(int32 Channel, const UObject* Listener, uint64 Order,
+                                               TFunction<void(const void*)>&& Handler);
+
+    void InsertSubscriber(int32 Channel, FSubscriber&& Subscriber);
+
+    void Dispatch(int32 Channel, const void* Payload);
+
+    // Runs a Reset requested while dispatching, keeping the subscriptions made after it.
+    void FinishPendingReset();
+
+    void* AllocDeferred(int32 Channel, int32 Size, int32 Alignment, void (*Destroy)(void*));
+
+    void UpdateMemoryStat();
+
+    // Indexed by channel id.
+    TArray<TArray<FSubscriber>> Subscribers;
+
+    // Subscribed while dispatching, inserted once the outermost dispatch returns.
+    TArray<TPair<int32, FSubscriber>> PendingSubscribers;
+
+    FEventQueue Queued;
+
+    FEventQueue Flushing;
+
+    uint64 NextSubscriberId = 1;
+
+    int32 DispatchDepth = 0;
+
+    bool bHasRemoved = false;
+
+    bool bIsFlushing = false;
+
+    bool bPendingReset = false;
+
+    SIZE_T ReportedMemory = 0;
+};
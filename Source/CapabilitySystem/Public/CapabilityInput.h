@@ -46,6 +46,26 @@ protected:
     UFUNCTION(BlueprintCallable)
     bool BindAction(const UInputAction* Action, ETriggerEvent TriggerEvent, UObject* Target, FName FunctionName);
 
+    /**
+      * Route a trigger event of Action straight into WakeUp, so the capability activates / deactivates
+      * in the same frame without ticking. Call from OnBindActions, e.g. Started to activate and Completed
+      * to let ShouldDeactivate run. The triggering instance is available through GetWakeUpActionInstance.
+      */
+    UFUNCTION(BlueprintCallable)
+    bool BindActivationAction(const UInputAction* Action, ETriggerEvent TriggerEvent);
+
+    UFUNCTION(BlueprintCallable)
+    FInputActionInstance GetWakeUpActionInstance() const { return WakeUpActionInstance; }
+
+    /**
+      * Latent task continuing on the next TriggerEvent of Action, which is only bound while waiting.
+      * Needs the input component.
+      */
+    UFUNCTION(BlueprintCallable)
+    FCapabilityTaskHandle WaitInput(const UInputAction* Action, ETriggerEvent TriggerEvent, FCapabilityTaskDelegate Then);
+
+    FCapabilityTaskHandle WaitInput(const UInputAction* Action, ETriggerEvent TriggerEvent, TFunction<void()>&& Then);
+
     UFUNCTION(BlueprintCallable)
     bool BindInputMappingContext(const UInputMappingContext* Context, int32 IMC_Priority = 0);
     
@@ -66,9 +86,36 @@ protected:
     UEnhancedInputLocalPlayerSubsystem* TryGetEnhancedInputSubsystem() const;
 
 private:
+    void OnActivationActionTriggered(const FInputActionInstance& Instance);
+
+    // Records the InputBufferTriggerEvents of Action once per capability, whatever event the caller binds.
+    void BindInputRecorder(const UInputAction* Action);
+
+    void OnBufferedActionTriggered(const FInputActionInstance& Instance);
+
+    FCapabilityTaskHandle StartInputTask(const UInputAction* Action, ETriggerEvent TriggerEvent, FCapabilityTask&& Task);
+
+    void OnTaskActionTriggered(const FInputActionInstance& Instance);
+
+    struct FInputWait {
+        uint64 TaskId = 0;
+
+        const UInputAction* Action = nullptr;
+
+        ETriggerEvent TriggerEvent = ETriggerEvent::None;
+    };
+
+    TArray<FInputWait> InputWaits;
+
     UPROPERTY()
     TArray<int32> ActionRecords;
 
+    // Actions with a recorder binding in ActionRecords.
+    TArray<const UInputAction*> RecordedActions;
+
+    UPROPERTY(Transient)
+    FInputActionInstance WakeUpActionInstance;
+
     TArray<TPair<const UInputMappingContext*, int32>> InputMappingContexts;
 
     UPROPERTY()
@@ -0,0 +1,64 @@
+﻿// Copyright ysion(LZY). All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InputAction.h"
+#include "InputTriggers.h"
+#include "CapabilityInputBuffer.generated.h"
+
+USTRUCT(BlueprintType)
+struct FCapabilityInputEvent {
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly)
+    TObjectPtr<const UInputAction> Action = nullptr;
+
+    UPROPERTY(BlueprintReadOnly)
+    ETriggerEvent TriggerEvent = ETriggerEvent::None;
+
+    UPROPERTY(BlueprintReadOnly)
+    FInputActionValue Value;
+
+    UPROPERTY(BlueprintReadOnly)
+    double WorldTime = 0.0;
+
+    // GFrameCounter when the event was recorded.
+    uint64 Frame = 0;
+
+    UPROPERTY(BlueprintReadOnly)
+    bool bConsumed = false;
+};
+
+/**
+ * Fixed capacity ring buffer of input events, oldest entries are overwritten.
+ * Storage is allocated once on the first push and reused afterwards.
+ */
+USTRUCT()
+struct CAPABILITYSYSTEM_API FCapabilityInputBuffer {
+    GENERATED_BODY()
+
+    void Push(const FCapabilityInputEvent& Event, int32 Capacity);
+
+    // Newest matching event recorded at or after MinWorldTime, null if none.
+    FCapabilityInputEvent* FindLatest(const UInputAction* Action, ETriggerEvent TriggerEvent, double MinWorldTime,
+                                      bool bIncludeConsumed);
+
+    const FCapabilityInputEvent* FindLatest(const UInputAction* Action, ETriggerEvent TriggerEvent, double MinWorldTime,
+                                            bool bIncludeConsumed) const;
+
+    bool IsEmpty() const { return Count == 0; }
+
+    void Reset();
+
+private:
+    int32 FindLatestIndex(const UInputAction* Action, ETriggerEvent TriggerEvent, double MinWorldTime,
+                          bool bIncludeConsumed) const;
+
+    UPROPERTY()
+    TArray<FCapabilityInputEvent> Events;
+
+    // Next write position.
+    int32 Head = 0;
+
+    int32 Count = 0;
+};
@@ -0,0 +1,69 @@
+﻿// Copyright ysion(LZY). All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CapabilityCommon.h"
+#include "CapabilityLOD.generated.h"
+
+class UCapabilityComponent;
+
+DECLARE_CYCLE_STAT(TEXT("Capability LOD Update"), STAT_Capability_LODUpdate, STATGROUP_Capability);
+
+struct FCapabilityLODViewInfo {
+    TArray<FVector, TInlineAllocator<4>> ViewLocations;
+
+    bool bIsDedicatedServer = false;
+};
+
+// Returns the significance of a component, lower is more significant (distance-like).
+using FCapabilitySignificanceFunction = TFunction<float(const UCapabilityComponent&, const FCapabilityLODViewInfo&)>;
+
+/**
+ * Maps every registered capability component to a LOD tier (see UCapabilitySystemSetting::LODTiers).
+ * Tiers scale the tick interval of capabilities or suspend tagged categories, with hysteresis between tiers.
+ * Only created when bEnableTickLOD is set and at least one tier is configured.
+ */
+UCLASS()
+class CAPABILITYSYSTEM_API UCapabilityLODSubsystem : public UTickableWorldSubsystem {
+    GENERATED_BODY()
+public:
+
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+    virtual void Tick(float DeltaTime) override;
+
+    virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UCapabilityLODSubsystem, STATGROUP_Capability); }
+
+    void RegisterComponent(UCapabilityComponent* Component);
+
+    void UnregisterComponent(UCapabilityComponent* Component);
+
+    // Replace the significance function, pass nullptr to restore the default (nearest viewer distance + render visibility).
+    void SetSignificanceFunction(FCapabilitySignificanceFunction InFunction);
+
+    const FCapabilityLODTier* GetTierInfo(int32 Tier) const;
+
+    static float DefaultSignificance(const UCapabilityComponent& Component, const FCapabilityLODViewInfo& ViewInfo);
+
+private:
+
+    int32 ComputeTier(float Significance, int32 CurrentTier) const;
+
+    void GatherViewInfo(FCapabilityLODViewInfo& OutViewInfo) const;
+
+    UPROPERTY()
+    TArray<TWeakObjectPtr<UCapabilityComponent>> Components;
+
+    FCapabilitySignificanceFunction SignificanceFunction;
+
+    TArray<FCapabilityLODTier> Tiers;
+
+    float UpdateInterval = 0.25f;
+
+    float Hysteresis = 0.1f;
+
+    float TimeSinceUpdate = 0.0f;
+};
@@ -0,0 +1,155 @@
+﻿// Copyright ysion(LZY). All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CapabilityBase.h"
+#include "InstancedStructContainer.h"
+#include "CapabilityLite.generated.h"
+
+class UCapabilityComponent;
+struct FMassExecutionContext;
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Lite Capability Count"), STAT_LiteCapabilityCount, STATGROUP_Capability);
+
+// Block state of a lite capability host that has no UCapabilityComponent (e.g. a Mass entity).
+USTRUCT()
+struct CAPABILITYSYSTEM_API FCapabilityLiteBlockState {
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<FName> Tags;
+
+    UPROPERTY()
+    TArray<TWeakObjectPtr<UObject>> From;
+
+    // Seconds left of each timed entry, 0 for entries without a duration.
+    UPROPERTY()
+    TArray<float> RemainingTime;
+
+    // Set whenever Tags changes, lets hosts cache derived block masks.
+    bool bDirty = false;
+
+    // A later block of the same tag and source replaces the duration, 0 makes it permanent.
+    void Block(const FName& Tag, UObject* Source, float Duration = 0.0f);
+
+    void UnBlock(const FName& Tag, UObject* Source);
+
+    // Counts the timed entries down, called by the host once per frame.
+    void AdvanceTimedBlocks(float DeltaTime);
+
+    bool IsBlocked(const TArray<FName>& CapabilityTags) const;
+};
+
+struct FCapabilityLiteContext {
+    UCapabilityComponent* Component = nullptr;
+
+    AActor* Owner = nullptr;
+
+    // Set by backends running lite capabilities without a component.
+    FMassExecutionContext* MassContext = nullptr;
+
+    int32 EntityIndex = INDEX_NONE;
+
+    FCapabilityLiteBlockState* BlockState = nullptr;
+};
+
+/**
+ * Lightweight capability stored inline in its component (no UObject, no replication, no GC tracking).
+ * Listed in UCapabilitySet::LiteCapabilities and instantiated locally on every side from the set asset,
+ * then run with the same lifecycle, ordering and block-tag rules as UCapability.
+ * Derive a USTRUCT from it and override the virtual lifecycle functions.
+ */
+USTRUCT(BlueprintType)
+struct CAPABILITYSYSTEM_API FCapabilityLite {
+    GENERATED_BODY()
+
+    virtual ~FCapabilityLite() = default;
+
+    UPROPERTY(EditAnywhere)
+    TArray<FName> Tags;
+
+    UPROPERTY(EditAnywhere)
+    ECapabilityExecuteSide ExecuteSide = ECapabilityExecuteSide::Always;
+
+    UPROPERTY(EditAnywhere)
+    bool bCanEverTick = true;
+
+    UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", Units = "s"))
+    float TickInterval = 0.0f;
+
+    // Life Cycle
+    virtual void StartLife(const FCapabilityLiteContext& Context) {}
+
+    virtual void Setup(const FCapabilityLiteContext& Context) {}
+
+    virtual bool ShouldActive(const FCapabilityLiteContext& Context) { return true; }
+
+    virtual bool ShouldDeactivate(const FCapabilityLiteContext& Context) { return false; }
+
+    virtual void OnActivated(const FCapabilityLiteContext& Context) {}
+
+    virtual void OnDeactivated(const FCapabilityLiteContext& Context) {}
+
+    virtual void Tick(const FCapabilityLiteContext& Context, float DeltaTime) {}
+
+    virtual void EndCapability(const FCapabilityLiteContext& Context) {}
+
+    virtual void EndLife(const FCapabilityLiteContext& Context) {}
+
+    bool IsCapabilityActive() const { return bIsCapabilityActive; }
+
+    bool ShouldRunOnThisSide() const { return bShouldRunOnThisSide; }
+
+    bool ShouldTick() const { return bCanEverTick && bShouldRunOnThisSide && bHasBegunPlay && !bHasPreEndedPlay; }
+
+    void Activate(const FCapabilityLiteContext& Context);
+
+    void Deactivate(const FCapabilityLiteContext& Context);
+
+    void NativeBeginPlay(const FCapabilityLiteContext& Context);
+
+    void NativePreEndPlay(const FCapabilityLiteContext& Context);
+
+    void NativeEndPlay(const FCapabilityLiteContext& Context);
+
+    void NativeTick(const FCapabilityLiteContext& Context, float DeltaTime);
+
+    // Lite capabilities have no UObject identity, block sources are provided by the caller (e.g. a data component).
+    static void BlockCapability(const FCapabilityLiteContext& Context, const FName& Tag, UObject* From, float Duration = 0.0f);
+
+    static void UnBlockCapability(const FCapabilityLiteContext& Context, const FName& Tag, UObject* From);
+
+private:
+
+    void UpdateCapabilityState(const FCapabilityLiteContext& Context);
+
+    bool bHasBegunPlay = false;
+
+    bool bHasPreEndedPlay = false;
+
+    bool bHasEndedPlay = false;
+
+    bool bShouldRunOnThisSide = false;
+
+    bool bIsCapabilityActive = false;
+
+    float TickTimeSum = 0.0f;
+};
+
+// Lite capabilities of one capability set instance, stored contiguously.
+USTRUCT()
+struct FCapabilityLiteSet {
+    GENERATED_BODY()
+
+    UPROPERTY()
+    uint32 InstanceID = 0;
+
+    UPROPERTY()
+    FInstancedStructContainer Capabilities;
+
+    void CallBeginPlay(const FCapabilityLiteContext& Context);
+
+    void CallPreEndPlay(const FCapabilityLiteContext& Context);
+
+    void CallEndPlay(const FCapabilityLiteContext& Context);
+};
@@ -0,0 +1,34 @@
+﻿// Copyright ysion(LZY). All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FCapabilityLoadoutSet {
+    FSoftObjectPath Set;
+
+    // SerializeLoadoutState output per capability in set order, empty for capabilities that write nothing.
+    TArray<TArray<uint8>> CapabilityStates;
+};
+
+/**
+ * Persistent capability loadout of a component: the capability sets in add order, the blocked tags
+ * and the opted-in capability state. Paths and names are stored as strings so the data survives restarts.
+ */
+struct CAPABILITYSYSTEM_API FCapabilityLoadout {
+    TArray<FCapabilityLoadoutSet> Sets;
+
+    TArray<FName> BlockedTags;
+
+    // Remaining seconds of each BlockedTags entry, 0 for blocks without a duration.
+    TArray<float> BlockedTagDurations;
+
+    void Write(TArray<uint8>& OutData);
+
+    // False if Data is not a loadout of a known version.
+    bool Read(const TArray<uint8>& Data);
+
+    void Reset();
+
+private:
+    void Serialize(FArchive& Ar, int32 Version);
+};
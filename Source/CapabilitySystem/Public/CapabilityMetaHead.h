@@ -15,6 +15,17 @@ public:
     UPROPERTY(Replicated)
     TArray<TWeakObjectPtr<UCapabilityBase>> CapabilityList;
 
+    // Capabilities the dedicated server did not create, spawned by each client with their index in the set.
+    UPROPERTY(Replicated)
+    TArray<TSubclassOf<UCapabilityBase>> ClientOnlyClasses;
+
+    UPROPERTY(Replicated)
+    TArray<int16> ClientOnlyIndices;
+
+    // Client side instances of ClientOnlyClasses, ended together with the replicated capabilities.
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<UCapabilityBase>> LocalCapabilities;
+
     bool bHasEndPlayCalled = false;
 
     void CallEndPlay();
@@ -0,0 +1,55 @@
+﻿// Copyright ysion(LZY). All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CapabilityCommon.h"
+
+DECLARE_CYCLE_STAT(TEXT("Capability Snapshot Save"), STAT_Capability_SnapshotSave, STATGROUP_Capability)
+DECLARE_CYCLE_STAT(TEXT("Capability Snapshot Restore"), STAT_Capability_SnapshotRestore, STATGROUP_Capability)
+DECLARE_MEMORY_STAT(TEXT("Capability Snapshot Memory"), STAT_CapabilitySnapshotMemory, STATGROUP_Capability);
+
+// Runtime state of one component at one simulation frame. Data is only valid within the running process.
+struct FCapabilityStateFrame {
+    int32 Frame = INDEX_NONE;
+
+    // Hash of the capability sets the data was written for, restoring into a different layout is refused.
+    uint32 Topology = 0;
+
+    TArray<uint8> Data;
+};
+
+/**
+ * Fixed capacity ring of state frames in ascending frame order, oldest frames are overwritten.
+ * Frame slots and their byte buffers are allocated while the ring warms up and reused afterwards.
+ */
+struct CAPABILITYSYSTEM_API FCapabilityStateRing {
+    ~FCapabilityStateRing();
+
+    // Slot to write Frame into, frames at or after Frame are discarded first.
+    FCapabilityStateFrame& Write(int32 Frame, int32 Capacity);
+
+    const FCapabilityStateFrame* Find(int32 Frame) const;
+
+    // Drops every frame newer than Frame, resimulation writes them again.
+    void DiscardAfter(int32 Frame);
+
+    int32 Num() const { return Count; }
+
+    void Reset();
+
+    SIZE_T GetAllocatedSize() const;
+
+    // Reports the current buffer sizes to STAT_CapabilitySnapshotMemory.
+    void UpdateMemoryStat();
+
+private:
+    TArray<FCapabilityStateFrame> Frames;
+
+    // Next write position.
+    int32 Head = 0;
+
+    int32 Count = 0;
+
+    // Bytes reported to STAT_CapabilitySnapshotMemory.
+    SIZE_T TrackedMemory = 0;
+};
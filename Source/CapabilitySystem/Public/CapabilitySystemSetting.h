@@ -0,0 +1,113 @@
+﻿// Copyright ysion(LZY). All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "InputTriggers.h"
+#include "CapabilitySystemSetting.generated.h"
+
+USTRUCT(BlueprintType)
+struct FCapabilityLODTier {
+    GENERATED_BODY()
+
+    // Significance (distance to the nearest viewer by default) from which this tier applies.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly)
+    float Significance = 0.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0.0"))
+    float TickIntervalScale = 1.0f;
+
+    // Lower bound of the effective tick interval, so capabilities ticking every frame are slowed down as well.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0.0", Units = "s"))
+    float MinTickInterval = 0.0f;
+
+    // Capabilities carrying any of these tags are suspended (no evaluation, no Tick) in this tier.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly)
+    TArray<FName> SuspendedTags;
+};
+
+UCLASS(Config = Game, DefaultConfig, meta = (DisplayName = "Capability System"))
+class CAPABILITYSYSTEM_API UCapabilitySystemSetting : public UDeveloperSettings {
+    GENERATED_BODY()
+public:
+
+    // Per-frame time budget (ms) shared by every capability component in a world. 0 disables budgeting.
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Tick Budget", meta = (ClampMin = "0.0", Units = "ms"))
+    float TickBudgetMs = 0.0f;
+
+    // While over budget, Normal priority capabilities only run every N frames (round-robin).
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Tick Budget", meta = (ClampMin = "1"))
+    int32 NormalPriorityDeferStride = 2;
+
+    // While over budget, Low priority capabilities only run every N frames (round-robin).
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Tick Budget", meta = (ClampMin = "1"))
+    int32 LowPriorityDeferStride = 4;
+
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Tick LOD")
+    bool bEnableTickLOD = false;
+
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Tick LOD", meta = (ClampMin = "0.0", Units = "s"))
+    float LODUpdateInterval = 0.25f;
+
+    // Relative margin around tier thresholds, avoids flickering between two tiers.
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Tick LOD", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float LODHysteresis = 0.1f;
+
+    // Default significance function: multiplier applied to actors that were not rendered recently (clients only).
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Tick LOD", meta = (ClampMin = "1.0"))
+    float NotRenderedSignificanceScale = 2.0f;
+
+    // Tier 0 is full rate; LODTiers[i] describes tier i + 1, sorted by ascending Significance.
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Tick LOD")
+    TArray<FCapabilityLODTier> LODTiers;
+
+    // Input events kept per capability component for buffered / combo input. 0 disables recording.
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Input Buffer", meta = (ClampMin = "0"))
+    int32 InputBufferCapacity = 32;
+
+    // Trigger events recorded into the input buffer. Continuous ones like Triggered would push the discrete ones out.
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Input Buffer")
+    TArray<ETriggerEvent> InputBufferTriggerEvents = {ETriggerEvent::Started, ETriggerEvent::Completed};
+
+    // Step (s) of fixed-timestep capabilities that have no tickInterval, components can override it.
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Fixed Timestep", meta = (ClampMin = "0.001", Units = "s"))
+    float FixedTimestep = 1.0f / 30.0f;
+
+    // Catch-up bound, steps beyond it are dropped after a long frame.
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Fixed Timestep", meta = (ClampMin = "1"))
+    int32 MaxFixedSubsteps = 4;
+
+    // Frames kept per component by UCapabilityComponent::SaveStateSnapshot. 0 disables snapshots.
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Rollback", meta = (ClampMin = "0"))
+    int32 RollbackSnapshotFrames = 32;
+
+    // Step (s) of the capability timing wheel (timed blocks), timers fire on the first step at or after their deadline.
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Timers", meta = (ClampMin = "0.001", Units = "s"))
+    float TimerResolution = 1.0f / 60.0f;
+
+    // Spawn a replicated block channel actor per world so tags can be blocked for whole groups of components.
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Block Channels")
+    bool bEnableBlockChannels = false;
+
+    // Tick capabilities marked bBatchTick class by class across all components of a world.
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Batch Tick")
+    bool bEnableBatchTick = false;
+
+    // Run bParallelTick capabilities of a set concurrently on worker threads where their declared data access allows.
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Parallel Tick")
+    bool bParallelCapabilityTick = false;
+
+    // Dedicated servers skip creating AllClients capabilities without RPCs, clients spawn them locally instead.
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Dedicated Server")
+    bool bStripClientOnlyCapabilities = false;
+
+    // Destroy data components and release capability objects of ended components over several frames.
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Teardown")
+    bool bDeferredTeardown = false;
+
+    // Per-frame time budget (ms) for deferred teardown, at least one object is released per frame.
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Teardown", meta = (ClampMin = "0.0", Units = "ms", EditCondition = "bDeferredTeardown"))
+    float TeardownBudgetMs = 0.5f;
+
+    UCapabilitySystemSetting() = default;
+};
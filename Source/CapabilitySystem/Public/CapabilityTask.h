@@ -0,0 +1,43 @@
+﻿// Copyright ysion(LZY). All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CapabilityCommon.h"
+#include "CapabilityTask.generated.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pending Capability Tasks"), STAT_PendingCapabilityTasks, STATGROUP_Capability);
+
+DECLARE_DYNAMIC_DELEGATE(FCapabilityTaskDelegate);
+
+// Identifies a latent task of one capability.
+USTRUCT(BlueprintType)
+struct FCapabilityTaskHandle {
+    GENERATED_BODY()
+
+    uint64 Id = 0;
+
+    FCapabilityTaskHandle() = default;
+
+    explicit FCapabilityTaskHandle(uint64 InId) : Id(InId) {}
+
+    bool IsValid() const { return Id != 0; }
+
+    void Invalidate() { Id = 0; }
+
+    bool operator==(const FCapabilityTaskHandle& Other) const { return Id == Other.Id; }
+};
+
+/**
+ * Suspended step of a capability's sequenced logic. Nothing runs per frame while it waits, it is resumed by the
+ * timer, input binding, block change or data notification it subscribed to, then continues with Then / Delegate.
+ */
+struct FCapabilityTask {
+    uint64 Id = 0;
+
+    TFunction<void()> Then;
+
+    FCapabilityTaskDelegate Delegate;
+
+    // Drops the subscription the task waits on, runs when it resumes or is cancelled.
+    TFunction<void()> Unsubscribe;
+};
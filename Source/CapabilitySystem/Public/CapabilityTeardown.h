@@ -0,0 +1,50 @@
+﻿// Copyright ysion(LZY). All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CapabilityCommon.h"
+#include "CapabilityTeardown.generated.h"
+
+DECLARE_CYCLE_STAT(TEXT("Capability Teardown"), STAT_Capability_Teardown, STATGROUP_Capability);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pending Capability Teardown"), STAT_PendingCapabilityTeardown, STATGROUP_Capability);
+
+/**
+ * Releases the data components and capability objects of components that ended play, a few per frame under
+ * UCapabilitySystemSetting::TeardownBudgetMs. Lifecycle callbacks already ran synchronously, only DestroyComponent /
+ * MarkAsGarbage are deferred. Only created when bDeferredTeardown is set.
+ */
+UCLASS()
+class CAPABILITYSYSTEM_API UCapabilityTeardownSubsystem : public UTickableWorldSubsystem {
+    GENERATED_BODY()
+public:
+
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+    virtual void Deinitialize() override;
+
+    virtual void Tick(float DeltaTime) override;
+
+    virtual bool IsTickable() const override { return Head < Pending.Num(); }
+
+    virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UCapabilityTeardownSubsystem, STATGROUP_Capability); }
+
+    // Released in the order given, data components are destroyed and every other object is marked as garbage.
+    void Enqueue(TConstArrayView<UObject*> Objects);
+
+    UFUNCTION(BlueprintCallable)
+    int32 GetPendingCount() const { return Pending.Num() - Head; }
+
+private:
+
+    static void Release(UObject* Object);
+
+    // Drained from Head, the released prefix is only compacted once it is the larger half.
+    TArray<TWeakObjectPtr<UObject>> Pending;
+
+    int32 Head = 0;
+
+    double BudgetSeconds = 0.0;
+};
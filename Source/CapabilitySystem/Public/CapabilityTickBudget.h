@@ -0,0 +1,71 @@
+﻿// Copyright ysion(LZY). All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CapabilityCommon.h"
+#include "CapabilityBase.h"
+#include "CapabilityTickBudget.generated.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deferred Capability Count"), STAT_DeferredCapabilityCount, STATGROUP_Capability);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Max Deferral Latency (ms)"), STAT_CapabilityMaxDeferralLatency, STATGROUP_Capability);
+
+/**
+ * World-wide tick budget for capability components.
+ * Components report how long their capabilities took; once the frame (or the previous frame) went over
+ * UCapabilitySystemSetting::TickBudgetMs, non-High priority capabilities are time-sliced round-robin
+ * and receive the accumulated delta when they run again.
+ * Only created when TickBudgetMs > 0.
+ */
+UCLASS()
+class CAPABILITYSYSTEM_API UCapabilityTickBudgetSubsystem : public UWorldSubsystem {
+    GENERATED_BODY()
+public:
+
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+    bool IsOverBudget();
+
+    bool ShouldDefer(ECapabilityTickPriority Priority, uint32 Slot) const;
+
+    void ConsumeBudget(uint64 Cycles);
+
+    void NotifyDeferred();
+
+    void NotifyResumed(float DeferredTime);
+
+    UFUNCTION(BlueprintCallable)
+    int32 GetDeferredCountLastFrame() const { return LastFrameDeferredCount; }
+
+    UFUNCTION(BlueprintCallable)
+    float GetMaxDeferralLatency() const { return MaxDeferralLatency; }
+
+    UFUNCTION(BlueprintCallable)
+    float GetLastFrameTickMs() const { return LastFrameSeconds * 1000.0; }
+
+private:
+
+    void RollFrame();
+
+    double BudgetSeconds = 0.0;
+
+    uint64 CurrentFrame = 0;
+
+    double FrameSeconds = 0.0;
+
+    double LastFrameSeconds = 0.0;
+
+    int32 FrameDeferredCount = 0;
+
+    int32 LastFrameDeferredCount = 0;
+
+    float FrameMaxLatency = 0.0f;
+
+    float MaxDeferralLatency = 0.0f;
+
+    uint32 NormalStride = 2;
+
+    uint32 LowStride = 4;
+};
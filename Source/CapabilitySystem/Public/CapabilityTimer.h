@@ -0,0 +1,124 @@
+﻿// Copyright ysion(LZY). All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CapabilityCommon.h"
+#include "CapabilityTimingWheel.h"
+#include "CapabilityTimer.generated.h"
+
+class UCapabilityBase;
+class UCapabilityComponent;
+
+DECLARE_CYCLE_STAT(TEXT("Capability Timers"), STAT_Capability_Timers, STATGROUP_Capability);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pending Timed Blocks"), STAT_PendingTimedBlocks, STATGROUP_Capability);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Active Capability Timers"), STAT_ActiveCapabilityTimers, STATGROUP_Capability);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Fired Capability Timers"), STAT_FiredCapabilityTimers, STATGROUP_Capability);
+
+DECLARE_DYNAMIC_DELEGATE(FCapabilityTimerDelegate);
+
+// Identifies a capability timer, stays the same across the repeats of a looping timer.
+USTRUCT(BlueprintType)
+struct FCapabilityTimerHandle {
+    GENERATED_BODY()
+
+    uint64 Id = 0;
+
+    FCapabilityTimerHandle() = default;
+
+    explicit FCapabilityTimerHandle(uint64 InId) : Id(InId) {}
+
+    bool IsValid() const { return Id != 0; }
+
+    void Invalidate() { Id = 0; }
+
+    bool operator==(const FCapabilityTimerHandle& Other) const { return Id == Other.Id; }
+};
+
+struct FCapabilityBlockExpiry {
+    TWeakObjectPtr<UCapabilityComponent> Component;
+
+    FName Tag;
+
+    TWeakObjectPtr<UObject> From;
+};
+
+struct FCapabilityTimer {
+    TWeakObjectPtr<UCapabilityBase> Capability;
+
+    FCapabilityTimerDelegate Delegate;
+
+    TFunction<void()> Callback;
+
+    FCapabilityTimingWheelHandle WheelHandle;
+
+    // Repeat interval in wheel ticks, 0 for one-shot timers.
+    uint64 LoopTicks = 0;
+
+    // Calls UCapabilityBase::WakeUp instead of a callback.
+    bool bWakeUp = false;
+};
+
+/**
+ * World clock for capability timers, backed by a hierarchical timing wheel advanced in
+ * UCapabilitySystemSetting::TimerResolution steps. Pending timers cost nothing per frame until they fire.
+ */
+UCLASS()
+class CAPABILITYSYSTEM_API UCapabilityTimerSubsystem : public UTickableWorldSubsystem {
+    GENERATED_BODY()
+public:
+
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+    virtual void Deinitialize() override;
+
+    virtual void Tick(float DeltaTime) override;
+
+    virtual bool IsTickable() const override { return BlockExpiries.Num() > 0 || TimerWheel.Num() > 0; }
+
+    virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UCapabilityTimerSubsystem, STATGROUP_Capability); }
+
+    // Calls UCapabilityComponent::OnTimedBlockExpired after Duration seconds.
+    FCapabilityTimingWheelHandle ScheduleBlockExpiry(UCapabilityComponent* Component, const FName& Tag, UObject* From,
+                                                     float Duration);
+
+    void CancelBlockExpiry(FCapabilityTimingWheelHandle& Handle);
+
+    float GetBlockRemainingTime(const FCapabilityTimingWheelHandle& Handle) const;
+
+    /**
+      * Timer owned by Capability, dropped once cleared or when the capability is gone. Prefer
+      * UCapabilityBase::SetCapabilityTimer, which also clears it at end play. Interval <= 0 makes it one-shot, otherwise it repeats every Interval seconds after the first Delay.
+      */
+    FCapabilityTimerHandle SetTimer(UCapabilityBase* Capability, FCapabilityTimer&& Timer, float Delay, float Interval);
+
+    void ClearTimer(FCapabilityTimerHandle& Handle);
+
+    bool IsTimerActive(const FCapabilityTimerHandle& Handle) const { return Timers.Contains(Handle.Id); }
+
+    float GetTimerRemainingTime(const FCapabilityTimerHandle& Handle) const;
+
+    int32 GetNumActiveTimers() const { return Timers.Num(); }
+
+    uint64 SecondsToTicks(float Seconds) const;
+
+private:
+
+    void FireTimer(uint64 Id);
+
+    float GetRemainingTime(uint64 Ticks) const;
+
+    TCapabilityTimingWheel<FCapabilityBlockExpiry> BlockExpiries;
+
+    // Wheel payload is the timer id, so a looping timer can be rescheduled behind a stable handle.
+    TCapabilityTimingWheel<uint64> TimerWheel;
+
+    TMap<uint64, FCapabilityTimer> Timers;
+
+    uint64 NextTimerId = 1;
+
+    double Resolution = 1.0 / 60.0;
+
+    // Time not yet converted into whole wheel ticks.
+    double PendingTime = 0.0;
+};
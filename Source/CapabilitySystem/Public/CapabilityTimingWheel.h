@@ -0,0 +1,192 @@
+﻿// Copyright ysion(LZY). All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FCapabilityTimingWheelHandle {
+    int32 Index = INDEX_NONE;
+
+    uint32 Serial = 0;
+
+    bool IsValid() const { return Index != INDEX_NONE; }
+
+    void Invalidate() {
+        Index = INDEX_NONE;
+        Serial = 0;
+    }
+
+    bool operator==(const FCapabilityTimingWheelHandle& Other) const {
+        return Index == Other.Index && Serial == Other.Serial;
+    }
+};
+
+/**
+ * Hierarchical timing wheel: NumLevels levels of 64 slots, level N covers 64^(N+1) ticks.
+ * Schedule and Cancel are O(1), an entry is cascaded at most once per level and fires in O(1).
+ * Advancing with no pending entries only moves the clock. Entries live in a pooled array with a free list,
+ * so storage is reused after warm up. Not thread safe.
+ */
+template <typename PayloadType, int32 NumLevels = 4>
+class TCapabilityTimingWheel {
+public:
+    static constexpr int32 SlotBits = 6;
+    static constexpr int32 NumSlots = 1 << SlotBits;
+    static constexpr uint64 SlotMask = NumSlots - 1;
+    static constexpr uint64 MaxDelayTicks = (uint64(1) << (SlotBits * NumLevels)) - 1;
+
+    TCapabilityTimingWheel() {
+        for (auto& Level : Slots) {
+            for (auto& Head : Level) Head = INDEX_NONE;
+        }
+    }
+
+    // Fires after DelayTicks calls worth of Advance (at least 1), delays past the wheel range are clamped.
+    FCapabilityTimingWheelHandle Schedule(uint64 DelayTicks, PayloadType&& Payload) {
+        int32 Index;
+        if (FreeHead != INDEX_NONE) {
+            Index = FreeHead;
+            FreeHead = Entries[Index].Next;
+        } else {
+            Index = Entries.AddDefaulted();
+        }
+
+        FEntry& Entry = Entries[Index];
+        Entry.Expire = CurrentTick + FMath::Clamp<uint64>(DelayTicks, 1, MaxDelayTicks);
+        Entry.Payload = MoveTemp(Payload);
+        Entry.bActive = true;
+        Link(Index);
+        ActiveCount++;
+
+        return FCapabilityTimingWheelHandle{Index, Entry.Serial};
+    }
+
+    // False if the entry already fired or was cancelled.
+    bool Cancel(const FCapabilityTimingWheelHandle& Handle) {
+        if (!IsPending(Handle)) return false;
+        Unlink(Handle.Index);
+        Release(Handle.Index);
+        return true;
+    }
+
+    bool IsPending(const FCapabilityTimingWheelHandle& Handle) const {
+        return Entries.IsValidIndex(Handle.Index) && Entries[Handle.Index].bActive
+            && Entries[Handle.Index].Serial == Handle.Serial;
+    }
+
+    // Ticks left until Handle fires, 0 if it is not pending.
+    uint64 GetRemainingTicks(const FCapabilityTimingWheelHandle& Handle) const {
+        return IsPending(Handle) ? Entries[Handle.Index].Expire - CurrentTick : 0;
+    }
+
+    /**
+     * Moves the clock by Ticks and calls OnExpire(PayloadType&&) for every entry that fires, in expiry order.
+     * OnExpire may schedule or cancel entries.
+     */
+    template <typename FuncType>
+    void Advance(uint64 Ticks, FuncType&& OnExpire) {
+        while (Ticks > 0) {
+            if (ActiveCount == 0) {
+                CurrentTick += Ticks;
+                return;
+            }
+            Ticks--;
+            CurrentTick++;
+
+            // Refill the lower levels from the next slot of a level whenever the level below wraps.
+            for (int32 Level = 1; Level < NumLevels; Level++) {
+                if ((CurrentTick >> (SlotBits * Level - SlotBits)) & SlotMask) break;
+                Cascade(Level, (CurrentTick >> (SlotBits * Level)) & SlotMask);
+            }
+
+            // Pop one at a time, OnExpire may cancel other entries of this slot. New entries never land here.
+            const int32& Head = Slots[0][CurrentTick & SlotMask];
+            while (Head != INDEX_NONE) {
+                const int32 Index = Head;
+                Unlink(Index);
+                PayloadType Payload = MoveTemp(Entries[Index].Payload);
+                Release(Index);
+                OnExpire(MoveTemp(Payload));
+            }
+        }
+    }
+
+    int32 Num() const { return ActiveCount; }
+
+    uint64 GetCurrentTick() const { return CurrentTick; }
+
+    void Reset() {
+        Entries.Reset();
+        FreeHead = INDEX_NONE;
+        ActiveCount = 0;
+        for (auto& Level : Slots) {
+            for (auto& Head : Level) Head = INDEX_NONE;
+        }
+    }
+
+    SIZE_T GetAllocatedSize() const { return Entries.GetAllocatedSize(); }
+
+private:
+    struct FEntry {
+        uint64 Expire = 0;
+        int32 Prev = INDEX_NONE;
+        int32 Next = INDEX_NONE;
+        uint32 Serial = 1;
+        int8 Level = 0;
+        uint8 Slot = 0;
+        bool bActive = false;
+        PayloadType Payload{};
+    };
+
+    TArray<FEntry> Entries;
+
+    int32 Slots[NumLevels][NumSlots];
+
+    int32 FreeHead = INDEX_NONE;
+
+    int32 ActiveCount = 0;
+
+    uint64 CurrentTick = 0;
+
+    void Link(int32 Index) {
+        FEntry& Entry = Entries[Index];
+        const uint64 Delta = Entry.Expire - CurrentTick;
+        int32 Level = 0;
+        while (Level < NumLevels - 1 && Delta >= (uint64(1) << (SlotBits * (Level + 1)))) Level++;
+
+        Entry.Level = Level;
+        Entry.Slot = (Entry.Expire >> (SlotBits * Level)) & SlotMask;
+        int32& Head = Slots[Level][Entry.Slot];
+        Entry.Prev = INDEX_NONE;
+        Entry.Next = Head;
+        if (Head != INDEX_NONE) Entries[Head].Prev = Index;
+        Head = Index;
+    }
+
+    void Unlink(int32 Index) {
+        FEntry& Entry = Entries[Index];
+        if (Entry.Prev != INDEX_NONE) Entries[Entry.Prev].Next = Entry.Next;
+        else Slots[Entry.Level][Entry.Slot] = Entry.Next;
+        if (Entry.Next != INDEX_NONE) Entries[Entry.Next].Prev = Entry.Prev;
+    }
+
+    void Release(int32 Index) {
+        FEntry& Entry = Entries[Index];
+        Entry.bActive = false;
+        Entry.Serial++;
+        Entry.Payload = PayloadType{};
+        Entry.Prev = INDEX_NONE;
+        Entry.Next = FreeHead;
+        FreeHead = Index;
+        ActiveCount--;
+    }
+
+    void Cascade(int32 Level, uint64 Slot) {
+        int32 Index = Slots[Level][Slot];
+        Slots[Level][Slot] = INDEX_NONE;
+        while (Index != INDEX_NONE) {
+            const int32 Next = Entries[Index].Next;
+            Link(Index);
+            Index = Next;
+        }
+    }
+};
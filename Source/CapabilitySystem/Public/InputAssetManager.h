@@ -7,6 +7,17 @@
 
 #include "InputAssetManager.generated.h"
 
+struct FStreamableHandle;
+
+UENUM()
+enum class EInputAssetLoadMode : uint8 {
+    // Load every listed asset while the game instance initializes (blocking).
+    Synchronous,
+    // Stream every listed asset in the background, lookups before completion load on demand.
+    AsyncPreload,
+    // Only load an asset the first time it is looked up.
+    OnDemand,
+};
 
 UCLASS(Config = Game, DefaultConfig, meta = (DisplayName = "Input Asset Manager"))
 class CAPABILITYSYSTEM_API UInputAssetManagerSetting : public UDeveloperSettings {
@@ -18,6 +29,13 @@ public:
 
     UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Config")
     TArray<TSoftObjectPtr<UInputMappingContext>> InputMappingContexts {};
+
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Loading")
+    EInputAssetLoadMode LoadMode = EInputAssetLoadMode::AsyncPreload;
+
+    // Dedicated servers never consume input assets, do not create the manager there.
+    UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Loading")
+    bool bSkipOnDedicatedServer = true;
     
     UInputAssetManagerSetting() = default;
 };
@@ -28,6 +46,8 @@ class CAPABILITYSYSTEM_API UInputAssetManager : public UGameInstanceSubsystem {
 public:
 
     inline static UInputAssetManager* Instance = nullptr;
+
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
     
     virtual void Initialize(FSubsystemCollectionBase& Collection) override;
     
@@ -41,15 +61,38 @@ public:
 
     FString ToStringAllIMC() const;
 
+    // True once every listed asset is loaded (always true in OnDemand mode).
+    bool IsReady() const { return bIsReady; }
+
+    // Broadcast when the async preload finished, bind before or check IsReady().
+    FSimpleMulticastDelegate OnInputAssetsReady;
+
 private:
     
     UPROPERTY()
-    TMap<FName, TObjectPtr<UInputAction>> InputActionMap;
+    mutable TMap<FName, TObjectPtr<UInputAction>> InputActionMap;
     
     UPROPERTY()
-    TMap<FName, TObjectPtr<UInputMappingContext>> InputMappingContextMap;
+    mutable TMap<FName, TObjectPtr<UInputMappingContext>> InputMappingContextMap;
+
+    // Asset name -> soft path of every listed asset, built without loading anything.
+    TMap<FName, FSoftObjectPath> InputActionPaths;
+
+    TMap<FName, FSoftObjectPath> InputMappingContextPaths;
+
+    TSharedPtr<FStreamableHandle> PreloadHandle;
+
+    bool bIsReady = false;
     
     void ScanAndLoadInputAssets();
+
+    void BuildAssetIndex();
+
+    void OnPreloadComplete();
+
+    template <typename T>
+    static T* ResolveAsset(const FName& Name, TMap<FName, TObjectPtr<T>>& LoadedMap,
+                           const TMap<FName, FSoftObjectPath>& PathMap, bool bLoadIfMissing);
 };
 
 UCLASS()
@@ -69,4 +112,7 @@ public:
 
     UFUNCTION(BlueprintCallable, Category = "InputAssetManager")
     static FString GetStringAllIMC();
+
+    UFUNCTION(BlueprintCallable, Category = "InputAssetManager")
+    static bool IsInputAssetsReady();
 };
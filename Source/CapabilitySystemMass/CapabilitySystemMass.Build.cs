@@ -0,0 +1,29 @@
+﻿using UnrealBuildTool;
+
+public class CapabilitySystemMass : ModuleRules
+{
+	public CapabilitySystemMass(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CapabilitySystem",
+				"MassEntity",
+				"MassSpawner",
+				"StructUtils"
+			}
+		);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"CoreUObject",
+				"Engine",
+				"MassCommon"
+			}
+		);
+	}
+}
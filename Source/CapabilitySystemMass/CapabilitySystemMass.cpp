@@ -0,0 +1,17 @@
+﻿// Copyright ySion. All Rights Reserved.
+
+#include "CapabilitySystemMass.h"
+
+#define LOCTEXT_NAMESPACE "FCapabilitySystemMassModule"
+
+void FCapabilitySystemMassModule::StartupModule()
+{
+}
+
+void FCapabilitySystemMassModule::ShutdownModule()
+{
+}
+
+#undef LOCTEXT_NAMESPACE
+
+IMPLEMENT_MODULE(FCapabilitySystemMassModule, CapabilitySystemMass)
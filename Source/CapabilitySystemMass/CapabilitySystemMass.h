@@ -0,0 +1,10 @@
+﻿// Copyright ysion(LZY). All Rights Reserved.
+
+#pragma once
+#include "Modules/ModuleManager.h"
+
+class FCapabilitySystemMassModule : public IModuleInterface {
+public:
+    virtual void StartupModule() override;
+    virtual void ShutdownModule() override;
+};
@@ -0,0 +1,221 @@
+﻿#include "CapabilityMassProcessor.h"
+#include "CapabilityMassSubsystem.h"
+#include "MassExecutionContext.h"
+#include "MassCommonTypes.h"
+#include "CapabilitySystem/Public/CapabilityCommon.h"
+
+bool FCapabilityMassSetRuntime::ShouldRunInWorld(const UWorld& World, ECapabilityExecuteSide Side) {
+    const ENetMode NetMode = World.GetNetMode();
+    switch (Side) {
+    case ECapabilityExecuteSide::Always:
+        return true;
+    case ECapabilityExecuteSide::AuthorityOnly:
+    case ECapabilityExecuteSide::AuthorityAndLocalControlled:
+        return NetMode != NM_Client;
+    case ECapabilityExecuteSide::AllClients:
+        return NetMode == NM_Client;
+    default:
+        // Entities have no controller, local controlled sides never run.
+        return false;
+    }
+}
+
+void FCapabilityMassSetRuntime::Build(const UCapabilitySet& Set, const UWorld& World) {
+    TArray<FInstancedStruct> ValidLites;
+    for (const auto& Lite : Set.LiteCapabilities) {
+        if (Lite.GetPtr<FCapabilityLite>()) ValidLites.Add(Lite);
+    }
+
+    if (ValidLites.Num() > CapabilityMassMaxCapabilities) {
+        UE_LOG(CapabilitySystemLog, Warning, TEXT("Capability set [%s] has %d lite capabilities, Mass agents only run the first %d."),
+               *Set.GetName(), ValidLites.Num(), CapabilityMassMaxCapabilities);
+        ValidLites.SetNum(CapabilityMassMaxCapabilities);
+    }
+
+    Prototypes.Reset();
+    Prototypes.Append(ValidLites);
+
+    RunMask = 0;
+    TickMask = 0;
+    TickIntervals.SetNumZeroed(Prototypes.Num());
+    for (int32 i = 0; i < Prototypes.Num(); i++) {
+        const FCapabilityLite* Lite = Get(i);
+        const uint64 Bit = 1ull << i;
+        if (ShouldRunInWorld(World, Lite->ExecuteSide)) RunMask |= Bit;
+        if (Lite->bCanEverTick) TickMask |= Bit;
+        TickIntervals[i] = Lite->TickInterval;
+    }
+}
+
+void FCapabilityMassSetRuntime::RecomputeBlockedMask(FCapabilityMassStateFragment& State) {
+    State.BlockedMask = 0;
+    State.BlockState.bDirty = false;
+    if (State.BlockState.Tags.IsEmpty()) return;
+    for (int32 i = 0; i < Prototypes.Num(); i++) {
+        if (State.BlockState.IsBlocked(Get(i)->Tags)) State.BlockedMask |= 1ull << i;
+    }
+}
+
+UCapabilityMassProcessor::UCapabilityMassProcessor() : EntityQuery(*this) {
+    ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::AllNetModes);
+    ProcessingPhase = EMassProcessingPhase::PrePhysics;
+    // Lite capabilities are written against the game thread, like their component counterpart.
+    bRequiresGameThreadExecution = true;
+}
+
+void UCapabilityMassProcessor::ConfigureQueries() {
+    EntityQuery.AddRequirement<FCapabilityMassStateFragment>(EMassFragmentAccess::ReadWrite);
+    EntityQuery.AddConstSharedRequirement<FCapabilityMassSetSharedFragment>();
+}
+
+void UCapabilityMassProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) {
+    SCOPE_CYCLE_COUNTER(STAT_CapabilityMass_Execute);
+
+    const UWorld* World = EntityManager.GetWorld();
+    auto Subsystem = World ? World->GetSubsystem<UCapabilityMassSubsystem>() : nullptr;
+    if (!Subsystem) return;
+
+    int32 AgentCount = 0;
+    EntityQuery.ForEachEntityChunk(EntityManager, Context, [Subsystem, &AgentCount](FMassExecutionContext& ChunkContext) {
+        const auto& SetFragment = ChunkContext.GetConstSharedFragment<FCapabilityMassSetSharedFragment>();
+        FCapabilityMassSetRuntime* Runtime = Subsystem->FindOrBuildRuntime(SetFragment.CapabilitySet);
+        if (!Runtime || Runtime->Prototypes.IsEmpty()) return;
+
+        const TArrayView<FCapabilityMassStateFragment> States = ChunkContext.GetMutableFragmentView<FCapabilityMassStateFragment>();
+        const int32 NumEntities = ChunkContext.GetNumEntities();
+        const int32 NumCapabilities = Runtime->Prototypes.Num();
+        const float DeltaTime = ChunkContext.GetDeltaTimeSeconds();
+        AgentCount += NumEntities;
+
+        FCapabilityLiteContext LiteContext;
+        LiteContext.MassContext = &ChunkContext;
+
+        // Begin play for entities created since the last frame, in set order.
+        for (int32 e = 0; e < NumEntities; e++) {
+            auto& State = States[e];
+            if (State.bHasBegunPlay) continue;
+            State.bHasBegunPlay = true;
+            State.TickAccumulators.SetNumZeroed(NumCapabilities);
+            LiteContext.EntityIndex = e;
+            LiteContext.BlockState = &State.BlockState;
+
+            for (int32 c = 0; c < NumCapabilities; c++) {
+                FCapabilityLite* Lite = Runtime->Get(c);
+                Lite->StartLife(LiteContext);
+                if (!(Runtime->RunMask & (1ull << c))) continue;
+                Lite->Setup(LiteContext);
+                if (!Lite->ShouldDeactivate(LiteContext)) {
+                    State.ActiveMask |= 1ull << c;
+                    Lite->OnActivated(LiteContext);
+                }
+            }
+        }
+
+        for (int32 e = 0; e < NumEntities; e++) {
+            auto& State = States[e];
+            if (!State.BlockState.Tags.IsEmpty()) State.BlockState.AdvanceTimedBlocks(DeltaTime);
+            if (State.BlockState.bDirty) Runtime->RecomputeBlockedMask(State);
+        }
+
+        const uint64 TickableMask = Runtime->RunMask & Runtime->TickMask;
+        for (int32 c = 0; c < NumCapabilities; c++) {
+            const uint64 Bit = 1ull << c;
+            if (!(TickableMask & Bit)) continue;
+
+            FCapabilityLite* Lite = Runtime->Get(c);
+            const float TickInterval = Runtime->TickIntervals[c];
+
+            for (int32 e = 0; e < NumEntities; e++) {
+                auto& State = States[e];
+                LiteContext.EntityIndex = e;
+                LiteContext.BlockState = &State.BlockState;
+
+                if (State.BlockedMask & Bit) {
+                    if (State.ActiveMask & Bit) {
+                        State.ActiveMask &= ~Bit;
+                        Lite->OnDeactivated(LiteContext);
+                    }
+                    continue;
+                }
+
+                // Interval ticks get the whole accumulated time, like FCapabilityLite::NativeTick.
+                float TickDelta = DeltaTime;
+                if (TickInterval > 0.0f) {
+                    float& TickTimeSum = State.TickAccumulators[c];
+                    TickTimeSum += DeltaTime;
+                    if (TickTimeSum < TickInterval) continue;
+                    TickDelta = TickTimeSum;
+                    TickTimeSum = 0.0f;
+                }
+
+                if (State.ActiveMask & Bit) {
+                    if (Lite->ShouldDeactivate(LiteContext)) {
+                        State.ActiveMask &= ~Bit;
+                        Lite->OnDeactivated(LiteContext);
+                    }
+                }
+                else if (Lite->ShouldActive(LiteContext)) {
+                    State.ActiveMask |= Bit;
+                    Lite->OnActivated(LiteContext);
+                }
+
+                if (State.ActiveMask & Bit) Lite->Tick(LiteContext, TickDelta);
+
+                // Blocks raised by this capability apply to the later capabilities of the same entity this frame.
+                if (State.BlockState.bDirty) Runtime->RecomputeBlockedMask(State);
+            }
+        }
+    });
+
+    SET_DWORD_STAT(STAT_CapabilityMassAgentCount, AgentCount);
+}
+
+UCapabilityMassTeardownObserver::UCapabilityMassTeardownObserver() : EntityQuery(*this) {
+    ObservedType = FCapabilityMassStateFragment::StaticStruct();
+    Operation = EMassObservedOperation::Remove;
+    ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::AllNetModes);
+    bRequiresGameThreadExecution = true;
+}
+
+void UCapabilityMassTeardownObserver::ConfigureQueries() {
+    EntityQuery.AddRequirement<FCapabilityMassStateFragment>(EMassFragmentAccess::ReadWrite);
+    EntityQuery.AddConstSharedRequirement<FCapabilityMassSetSharedFragment>();
+}
+
+void UCapabilityMassTeardownObserver::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) {
+    const UWorld* World = EntityManager.GetWorld();
+    auto Subsystem = World ? World->GetSubsystem<UCapabilityMassSubsystem>() : nullptr;
+    if (!Subsystem) return;
+
+    EntityQuery.ForEachEntityChunk(EntityManager, Context, [Subsystem](FMassExecutionContext& ChunkContext) {
+        const auto& SetFragment = ChunkContext.GetConstSharedFragment<FCapabilityMassSetSharedFragment>();
+        FCapabilityMassSetRuntime* Runtime = Subsystem->FindOrBuildRuntime(SetFragment.CapabilitySet);
+        if (!Runtime) return;
+
+        const TArrayView<FCapabilityMassStateFragment> States = ChunkContext.GetMutableFragmentView<FCapabilityMassStateFragment>();
+        FCapabilityLiteContext LiteContext;
+        LiteContext.MassContext = &ChunkContext;
+
+        for (int32 e = 0; e < ChunkContext.GetNumEntities(); e++) {
+            auto& State = States[e];
+            if (!State.bHasBegunPlay) continue;
+            LiteContext.EntityIndex = e;
+            LiteContext.BlockState = &State.BlockState;
+
+            // Reverse set order, matching FCapabilityLiteSet::CallPreEndPlay / CallEndPlay.
+            for (int32 c = Runtime->Prototypes.Num() - 1; c >= 0; --c) {
+                const uint64 Bit = 1ull << c;
+                if (State.ActiveMask & Bit) {
+                    State.ActiveMask &= ~Bit;
+                    Runtime->Get(c)->OnDeactivated(LiteContext);
+                }
+            }
+            for (int32 c = Runtime->Prototypes.Num() - 1; c >= 0; --c) {
+                FCapabilityLite* Lite = Runtime->Get(c);
+                if (Runtime->RunMask & (1ull << c)) Lite->EndCapability(LiteContext);
+                Lite->EndLife(LiteContext);
+            }
+            State.bHasBegunPlay = false;
+        }
+    });
+}
@@ -0,0 +1,15 @@
+﻿#include "CapabilityMassSubsystem.h"
+
+FCapabilityMassSetRuntime* UCapabilityMassSubsystem::FindOrBuildRuntime(const UCapabilitySet* Set) {
+    if (!Set) return nullptr;
+    if (auto Runtime = SetRuntimes.Find(Set)) return Runtime;
+
+    auto& Runtime = SetRuntimes.Add(Set);
+    Runtime.Build(*Set, *GetWorld());
+    return &Runtime;
+}
+
+void UCapabilityMassSubsystem::Deinitialize() {
+    SetRuntimes.Empty();
+    Super::Deinitialize();
+}
@@ -0,0 +1,20 @@
+﻿#include "CapabilityMassTrait.h"
+#include "CapabilityMassTypes.h"
+#include "MassEntityTemplateRegistry.h"
+#include "MassEntityUtils.h"
+#include "CapabilitySystem/Public/CapabilityCommon.h"
+
+void UCapabilityMassTrait::BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const {
+    const UCapabilitySet* Set = CapabilitySet.LoadSynchronous();
+    if (!Set) {
+        UE_LOG(CapabilitySystemLog, Warning, TEXT("Capability mass trait has no capability set, skipped."));
+        return;
+    }
+
+    BuildContext.AddFragment<FCapabilityMassStateFragment>();
+
+    FMassEntityManager& EntityManager = UE::Mass::Utils::GetEntityManagerChecked(World);
+    FCapabilityMassSetSharedFragment SetFragment;
+    SetFragment.CapabilitySet = Set;
+    BuildContext.AddConstSharedFragment(EntityManager.GetOrCreateConstSharedFragment(SetFragment));
+}
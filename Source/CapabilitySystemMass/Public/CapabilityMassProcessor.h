@@ -0,0 +1,45 @@
+﻿// Copyright ysion(LZY). All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassProcessor.h"
+#include "MassObserverProcessor.h"
+#include "CapabilityMassTypes.h"
+#include "CapabilityMassProcessor.generated.h"
+
+/**
+ * Runs the lite capabilities of a UCapabilitySet on every entity carrying FCapabilityMassStateFragment.
+ * Chunks are evaluated capability by capability (all entities of the chunk for capability 0, then capability 1...)
+ * so the same capability code and data stay hot, while each entity still sees the set order:
+ * a block raised by an earlier capability of an entity affects its later capabilities in the same frame.
+ */
+UCLASS()
+class CAPABILITYSYSTEMMASS_API UCapabilityMassProcessor : public UMassProcessor {
+    GENERATED_BODY()
+public:
+    UCapabilityMassProcessor();
+
+protected:
+    virtual void ConfigureQueries() override;
+
+    virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+    FMassEntityQuery EntityQuery;
+};
+
+// Runs PreEndPlay / EndPlay of the lite capabilities when the state fragment is removed (entity destroyed).
+UCLASS()
+class CAPABILITYSYSTEMMASS_API UCapabilityMassTeardownObserver : public UMassObserverProcessor {
+    GENERATED_BODY()
+public:
+    UCapabilityMassTeardownObserver();
+
+protected:
+    virtual void ConfigureQueries() override;
+
+    virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+    FMassEntityQuery EntityQuery;
+};
@@ -0,0 +1,21 @@
+﻿// Copyright ysion(LZY). All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CapabilityMassTypes.h"
+#include "CapabilityMassSubsystem.generated.h"
+
+// Owns the per set runtime data of the Mass backend, shared by the processor and the teardown observer.
+UCLASS()
+class CAPABILITYSYSTEMMASS_API UCapabilityMassSubsystem : public UWorldSubsystem {
+    GENERATED_BODY()
+public:
+    FCapabilityMassSetRuntime* FindOrBuildRuntime(const UCapabilitySet* Set);
+
+    virtual void Deinitialize() override;
+
+private:
+    UPROPERTY(Transient)
+    TMap<TObjectPtr<const UCapabilitySet>, FCapabilityMassSetRuntime> SetRuntimes;
+};
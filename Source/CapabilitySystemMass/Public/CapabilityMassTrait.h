@@ -0,0 +1,20 @@
+﻿// Copyright ysion(LZY). All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTraitBase.h"
+#include "CapabilitySystem/Public/CapabilityAsset.h"
+#include "CapabilityMassTrait.generated.h"
+
+// Adds the capability state fragment and the shared set to a Mass entity config.
+UCLASS(meta = (DisplayName = "Capability Set"))
+class CAPABILITYSYSTEMMASS_API UCapabilityMassTrait : public UMassEntityTraitBase {
+    GENERATED_BODY()
+public:
+
+    UPROPERTY(EditAnywhere, Category = "Capability")
+    TSoftObjectPtr<UCapabilitySet> CapabilitySet;
+
+protected:
+    virtual void BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const override;
+};
@@ -0,0 +1,71 @@
+﻿// Copyright ysion(LZY). All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+#include "CapabilitySystem/Public/CapabilityAsset.h"
+#include "CapabilitySystem/Public/CapabilityLite.h"
+#include "CapabilityMassTypes.generated.h"
+
+DECLARE_CYCLE_STAT(TEXT("Capability Mass Execute"), STAT_CapabilityMass_Execute, STATGROUP_Capability);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Capability Mass Agent Count"), STAT_CapabilityMassAgentCount, STATGROUP_Capability);
+
+// Mass agents run at most 64 lite capabilities per set, one bit per capability in the state masks.
+constexpr int32 CapabilityMassMaxCapabilities = 64;
+
+/**
+ * Per entity capability state. Capabilities themselves are the lite capabilities of the shared set,
+ * evaluated by UCapabilityMassProcessor; only their runtime state lives here.
+ */
+USTRUCT()
+struct CAPABILITYSYSTEMMASS_API FCapabilityMassStateFragment : public FMassFragment {
+    GENERATED_BODY()
+
+    uint64 ActiveMask = 0;
+
+    uint64 BlockedMask = 0;
+
+    bool bHasBegunPlay = false;
+
+    TArray<float, TInlineAllocator<8>> TickAccumulators;
+
+    UPROPERTY()
+    FCapabilityLiteBlockState BlockState;
+};
+
+// The capability set every entity of an archetype runs.
+USTRUCT()
+struct CAPABILITYSYSTEMMASS_API FCapabilityMassSetSharedFragment : public FMassConstSharedFragment {
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TObjectPtr<const UCapabilitySet> CapabilitySet = nullptr;
+};
+
+/**
+ * Per world, per set data shared by every agent: lite capability prototypes plus masks derived once.
+ * Lite capabilities run by the Mass backend are shared between agents, so they must keep any per agent
+ * state in fragments (reachable through FCapabilityLiteContext::MassContext / EntityIndex).
+ */
+USTRUCT()
+struct CAPABILITYSYSTEMMASS_API FCapabilityMassSetRuntime {
+    GENERATED_BODY()
+
+    UPROPERTY()
+    FInstancedStructContainer Prototypes;
+
+    // Capabilities allowed to run on this side (no owner, so controller based sides never run).
+    uint64 RunMask = 0;
+
+    uint64 TickMask = 0;
+
+    TArray<float> TickIntervals;
+
+    FCapabilityLite* Get(int32 Index) { return Prototypes[Index].GetPtr<FCapabilityLite>(); }
+
+    void Build(const UCapabilitySet& Set, const UWorld& World);
+
+    void RecomputeBlockedMask(FCapabilityMassStateFragment& State);
+
+    static bool ShouldRunInWorld(const UWorld& World, ECapabilityExecuteSide Side);
+};